@@ -21,6 +21,7 @@ class adjacency_degreesortedlistmat
   using base = adjacency_listmat<Index, DirectedCategory, VertexLabel, EdgeLabel>;
 
  public:
+  using neighbour_order = degree_sorted_tag;
 
   template <
       typename G,
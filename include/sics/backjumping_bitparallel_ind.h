@@ -0,0 +1,257 @@
+#ifndef SICS_BACKJUMPING_BITPARALLEL_IND_H_
+#define SICS_BACKJUMPING_BITPARALLEL_IND_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include "block_bitset.h"
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// backjumping_ind with a bit-parallel consistency check over levels instead
+// of target vertices.  image_adjacency[y] has bit i set iff the image of the
+// vertex at level i is adjacent to y; every assignment updates it along the
+// adjacency of its image.  The levels of the earlier neighbours of each
+// pattern vertex are fixed by the order, so a candidate y for x is
+// consistent iff it is unused and
+//
+//   image_adjacency[y] == earlier_neighbour_levels[level]
+//
+// and the lowest bit in which they differ is the earliest level whose
+// adjacency to y is wrong, the culprit backjumping needs.  Each check is
+// O(m/64) word operations instead of O(level) edge lookups, for O(deg(v))
+// bit updates per assignment of v.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void backjumping_bitparallel_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    // bitsets over levels; for directed graphs std::get<0> is about
+    // out-neighbours and std::get<1> about in-neighbours
+    using bits_type = std::conditional_t<
+        is_directed_v<G>,
+        std::tuple<block_bitset, block_bitset>,
+        std::tuple<block_bitset>>;
+
+    std::vector<bits_type> earlier_neighbour_levels;
+    void build_earlier_neighbour_levels() {
+      for (IndexG l=0; l<m; ++l) {
+        auto x = index_order_g[l];
+        auto & bits = earlier_neighbour_levels[l];
+        for (IndexG i=0; i<l; ++i) {
+          auto u = index_order_g[i];
+          if (g.edge(x, u)) {
+            std::get<0>(bits).set(i);
+          }
+          if constexpr (is_directed_v<G>) {
+            if (g.edge(u, x)) {
+              std::get<1>(bits).set(i);
+            }
+          }
+        }
+      }
+    }
+
+    IndexG level;
+    IndexG backjump_level;
+
+    std::vector<IndexH> map;
+    // image_level[v]: the level whose vertex is mapped to v, or m
+    std::vector<IndexG> image_level;
+
+    std::vector<bits_type> image_adjacency;
+    void set_image_adjacency(IndexH v) {
+      if constexpr (is_directed_v<H>) {
+        for (auto ie : h.in_edges(v)) {
+          std::get<0>(image_adjacency[ie.target]).set(level);
+        }
+        for (auto oe : h.out_edges(v)) {
+          std::get<1>(image_adjacency[oe.target]).set(level);
+        }
+      } else {
+        for (auto e : h.edges(v)) {
+          std::get<0>(image_adjacency[e.target]).set(level);
+        }
+      }
+    }
+    void reset_image_adjacency(IndexH v) {
+      if constexpr (is_directed_v<H>) {
+        for (auto ie : h.in_edges(v)) {
+          std::get<0>(image_adjacency[ie.target]).reset(level);
+        }
+        for (auto oe : h.out_edges(v)) {
+          std::get<1>(image_adjacency[oe.target]).reset(level);
+        }
+      } else {
+        for (auto e : h.edges(v)) {
+          std::get<0>(image_adjacency[e.target]).reset(level);
+        }
+      }
+    }
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          earlier_neighbour_levels(m),
+          level{0},
+          backjump_level{0},
+          map(m, n),
+          image_level(n, m),
+          image_adjacency(n) {
+      for (auto & bits : earlier_neighbour_levels) {
+        std::get<0>(bits).resize(m);
+        if constexpr (is_directed_v<G>) {
+          std::get<1>(bits).resize(m);
+        }
+      }
+      for (auto & bits : image_adjacency) {
+        std::get<0>(bits).resize(m);
+        if constexpr (is_directed_v<G>) {
+          std::get<1>(bits).resize(m);
+        }
+      }
+      build_earlier_neighbour_levels();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+        bool proceed = true;
+        backjump_level = level + 1;
+        IndexG latest = 0;
+        for (IndexH y=0; y<n; ++y) {
+          IndexG culprit = consistency(y);
+          if (culprit > level) {
+            map[x] = y;
+            image_level[y] = level;
+            set_image_adjacency(y);
+            ++level;
+            proceed = explore();
+            --level;
+            reset_image_adjacency(y);
+            image_level[y] = m;
+            map[x] = n;
+            if (!proceed || backjump_level <= level) {
+              break;
+            }
+          }
+          if (culprit > latest) {
+            latest = culprit;
+          }
+        }
+        if (backjump_level > level && latest <= level) {
+          backjump_level = latest;
+        }
+        return proceed;
+      }
+    }
+
+    // One past a level y conflicts with, level + 1 if there is none, and 0
+    // if y fails vertex_equiv.
+    IndexG consistency(IndexH y) {
+      auto x = index_order_g[level];
+
+      if (!vertex_equiv(g, x, h, y)) {
+        return 0;
+      }
+
+      auto c = std::min(image_level[y], level);
+      auto const & adj = image_adjacency[y];
+      auto const & exp = earlier_neighbour_levels[level];
+      c = std::min(c, first_difference(std::get<0>(adj), std::get<0>(exp)));
+      if constexpr (is_directed_v<G>) {
+        c = std::min(c, first_difference(std::get<1>(adj), std::get<1>(exp)));
+      }
+
+      // any level y conflicts with is a sound culprit, so the edge labels
+      // are only looked at for a y whose adjacency is right
+      if (c == level) {
+        for (auto i=std::get<0>(exp).find_first(); i<c; i=std::get<0>(exp).find_next(i)) {
+          auto u = index_order_g[i];
+          if (!edge_equiv(g, x, u, h, y, map[u])) {
+            return i + 1;
+          }
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto i=std::get<1>(exp).find_first(); i<c; i=std::get<1>(exp).find_next(i)) {
+            auto u = index_order_g[i];
+            if (!edge_equiv(g, u, x, h, map[u], y)) {
+              return i + 1;
+            }
+          }
+        }
+      }
+      return c + 1;
+    }
+
+    // the lowest bit set in exactly one of a and b, or level if there is none
+    IndexG first_difference(block_bitset const & a, block_bitset const & b) {
+      for (std::size_t k=0; k<a.num_blocks(); ++k) {
+        auto d = a.data()[k] ^ b.data()[k];
+        if (d) {
+          return k * block_bitset::bits_per_block + __builtin_ctzll(d);
+        }
+      }
+      return level;
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_BACKJUMPING_BITPARALLEL_IND_H_
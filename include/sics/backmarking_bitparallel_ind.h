@@ -0,0 +1,286 @@
+#ifndef SICS_BACKMARKING_BITPARALLEL_IND_H_
+#define SICS_BACKMARKING_BITPARALLEL_IND_H_
+
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include "block_bitset.h"
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// backmarking_ind with the bit-parallel consistency check of
+// backtracking_bitparallel_ind.  A mark needs the earliest level a candidate
+// conflicts with, which the word operations do not give, so they only settle
+// the candidates that pass; the ones that fail are scanned from low[level]
+// on as in backmarking_ind.  The marks already keep that scan short, so
+// unlike backjumping_bitparallel_ind this does not keep per-level adjacency
+// bitsets, whose upkeep on every assignment costs more than it saves here.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void backmarking_bitparallel_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    using bits_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<block_bitset, block_bitset>,
+        std::tuple<block_bitset>>;
+
+    std::vector<bits_type> h_bits;
+    void build_h_bits() {
+      for (IndexH i=0; i<n; ++i) {
+        std::get<0>(h_bits[i]).resize(n);
+        if constexpr (is_directed_v<H>) {
+          std::get<1>(h_bits[i]).resize(n);
+        }
+      }
+
+      for (IndexH i=0; i<n; ++i) {
+        for (auto oe : edges_or_out_edges(h, i)) {
+          std::get<0>(h_bits[i]).set(oe.target);
+          if constexpr (is_directed_v<H>) {
+            std::get<1>(h_bits[oe.target]).set(i);
+          }
+        }
+      }
+    }
+
+    // earlier neighbours of index_order_g[level]; for directed graphs
+    // std::get<0> holds out-neighbours and std::get<1> in-neighbours
+    using neighbours_type = std::conditional_t<
+        is_directed_v<G>,
+        std::tuple<std::vector<IndexG>, std::vector<IndexG>>,
+        std::tuple<std::vector<IndexG>>>;
+
+    std::vector<neighbours_type> earlier_neighbours;
+    void build_earlier_neighbours() {
+      std::vector<bool> done(m, false);
+      for (IndexG i=0; i<m; ++i) {
+        auto x = index_order_g[i];
+        for (auto oe : edges_or_out_edges(g, x)) {
+          if (done[oe.target]) {
+            std::get<0>(earlier_neighbours[i]).push_back(oe.target);
+          }
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto ie : g.in_edges(x)) {
+            if (done[ie.target]) {
+              std::get<1>(earlier_neighbours[i]).push_back(ie.target);
+            }
+          }
+        }
+        done[x] = true;
+      }
+    }
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+
+    std::vector<IndexG> low;
+    std::vector<IndexG> M;
+    IndexG M_get(IndexG u, IndexH v) {
+      return M[u*n + v];
+    }
+    void M_set(IndexG u, IndexH v, IndexG l) {
+      M[u*n + v] = l;
+    }
+    void build_M() {
+      for (IndexG u=0; u<m; ++u) {
+        for (IndexH v=0; v<n; ++v) {
+          if (!vertex_equiv(g, u, h, v)) {
+            M_set(u, v, 0);
+          }
+        }
+      }
+    }
+
+    block_bitset used;
+    std::vector<bits_type> expected;
+    void build_expected() {
+      auto & exp = expected[level];
+      std::get<0>(exp).reset();
+      for (auto u : std::get<0>(earlier_neighbours[level])) {
+        std::get<0>(exp).set(map[u]);
+      }
+      if constexpr (is_directed_v<G>) {
+        std::get<1>(exp).reset();
+        for (auto u : std::get<1>(earlier_neighbours[level])) {
+          std::get<1>(exp).set(map[u]);
+        }
+      }
+    }
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          h_bits(n),
+          earlier_neighbours(m),
+          level{0},
+          map(m, n),
+          low(m, 0),
+          M(m * n, m),
+          used(n),
+          expected(m) {
+      build_h_bits();
+      build_earlier_neighbours();
+      for (auto & exp : expected) {
+        std::get<0>(exp).resize(n);
+        if constexpr (is_directed_v<H>) {
+          std::get<1>(exp).resize(n);
+        }
+      }
+      build_M();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+        build_expected();
+        bool proceed = true;
+        for (IndexH y=0; y<n; ++y) {
+          if (consistency(y)) {
+            for (IndexG i=level+1; i<m && level<low[i]; ++i) {
+              low[i] = level;
+            }
+            map[x] = y;
+            used.set(y);
+            ++level;
+            proceed = explore();
+            --level;
+            used.reset(y);
+            map[x] = n;
+            if (!proceed) {
+              break;
+            }
+          }
+        }
+        low[level] = level;
+        return proceed;
+      }
+    }
+
+    bool consistency(IndexH y) {
+      auto x = index_order_g[level];
+
+      if (M_get(x, y) <= low[level]) {
+        return false;
+      }
+
+      if (!used.test(y) && adjacency_matches(y) && edges_match(y)) {
+        M_set(x, y, m);
+        return true;
+      }
+
+      for (IndexG i=low[level]; i<level; ++i) {
+        auto u = index_order_g[i];
+        auto v = map[u];
+
+        if (v == y) {
+          M_set(x, y, i+1);
+          return false;
+        }
+
+        auto x_out = g.edge(x, u);
+        if (x_out != h.edge(y, v) || (x_out && !edge_equiv(g, x, u, h, y, v))) {
+          M_set(x, y, i+1);
+          return false;
+        }
+        if constexpr (is_directed_v<G>) {
+          auto x_in = g.edge(u, x);
+          if (x_in != h.edge(v, y) || (x_in && !edge_equiv(g, u, x, h, v, y))) {
+            M_set(x, y, i+1);
+            return false;
+          }
+        }
+      }
+      M_set(x, y, m);
+      return true;
+    }
+
+    bool adjacency_matches(IndexH y) {
+      auto const & exp = expected[level];
+      if (!std::get<0>(h_bits[y]).and_equals(used, std::get<0>(exp))) {
+        return false;
+      }
+      if constexpr (is_directed_v<G>) {
+        if (!std::get<1>(h_bits[y]).and_equals(used, std::get<1>(exp))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool edges_match(IndexH y) {
+      auto x = index_order_g[level];
+      for (auto u : std::get<0>(earlier_neighbours[level])) {
+        if (!edge_equiv(g, x, u, h, y, map[u])) {
+          return false;
+        }
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto u : std::get<1>(earlier_neighbours[level])) {
+          if (!edge_equiv(g, u, x, h, map[u], y)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_BACKMARKING_BITPARALLEL_IND_H_
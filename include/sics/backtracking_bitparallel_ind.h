@@ -0,0 +1,226 @@
+#ifndef SICS_BACKTRACKING_BITPARALLEL_IND_H_
+#define SICS_BACKTRACKING_BITPARALLEL_IND_H_
+
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include "block_bitset.h"
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// backtracking_ind with a bit-parallel consistency check.  A candidate y for
+// x is consistent iff it is unused and the used target vertices adjacent to y
+// are exactly the images of the earlier neighbours of x:
+//
+//   h_bits[y] & used == image(earlier neighbours of x)
+//
+// The right-hand side does not depend on y, so it is built once per level and
+// each check is O(n/64) word operations instead of O(level) edge lookups.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void backtracking_bitparallel_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    using bits_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<block_bitset, block_bitset>,
+        std::tuple<block_bitset>>;
+
+    std::vector<bits_type> h_bits;
+    void build_h_bits() {
+      for (IndexH i=0; i<n; ++i) {
+        std::get<0>(h_bits[i]).resize(n);
+        if constexpr (is_directed_v<H>) {
+          std::get<1>(h_bits[i]).resize(n);
+        }
+      }
+
+      for (IndexH i=0; i<n; ++i) {
+        for (auto oe : edges_or_out_edges(h, i)) {
+          std::get<0>(h_bits[i]).set(oe.target);
+          if constexpr (is_directed_v<H>) {
+            std::get<1>(h_bits[oe.target]).set(i);
+          }
+        }
+      }
+    }
+
+    // earlier neighbours of index_order_g[level]; for directed graphs
+    // std::get<0> holds out-neighbours and std::get<1> in-neighbours
+    using neighbours_type = std::conditional_t<
+        is_directed_v<G>,
+        std::tuple<std::vector<IndexG>, std::vector<IndexG>>,
+        std::tuple<std::vector<IndexG>>>;
+
+    std::vector<neighbours_type> earlier_neighbours;
+    void build_earlier_neighbours() {
+      std::vector<bool> done(m, false);
+      for (IndexG i=0; i<m; ++i) {
+        auto x = index_order_g[i];
+        for (auto oe : edges_or_out_edges(g, x)) {
+          if (done[oe.target]) {
+            std::get<0>(earlier_neighbours[i]).push_back(oe.target);
+          }
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto ie : g.in_edges(x)) {
+            if (done[ie.target]) {
+              std::get<1>(earlier_neighbours[i]).push_back(ie.target);
+            }
+          }
+        }
+        done[x] = true;
+      }
+    }
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+
+    block_bitset used;
+    std::vector<bits_type> expected;
+    void build_expected() {
+      auto & exp = expected[level];
+      std::get<0>(exp).reset();
+      for (auto u : std::get<0>(earlier_neighbours[level])) {
+        std::get<0>(exp).set(map[u]);
+      }
+      if constexpr (is_directed_v<G>) {
+        std::get<1>(exp).reset();
+        for (auto u : std::get<1>(earlier_neighbours[level])) {
+          std::get<1>(exp).set(map[u]);
+        }
+      }
+    }
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          h_bits(n),
+          earlier_neighbours(m),
+          level{0},
+          map(m, n),
+          used(n),
+          expected(m) {
+      build_h_bits();
+      build_earlier_neighbours();
+      for (auto & exp : expected) {
+        std::get<0>(exp).resize(n);
+        if constexpr (is_directed_v<H>) {
+          std::get<1>(exp).resize(n);
+        }
+      }
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+        build_expected();
+        bool proceed = true;
+        for (IndexH y=0; y<n; ++y) {
+          if (consistency(y)) {
+            map[x] = y;
+            used.set(y);
+            ++level;
+            proceed = explore();
+            --level;
+            used.reset(y);
+            map[x] = n;
+            if (!proceed) {
+              break;
+            }
+          }
+        }
+        return proceed;
+      }
+    }
+
+    bool consistency(IndexH y) {
+      auto x = index_order_g[level];
+
+      if (used.test(y) || !vertex_equiv(g, x, h, y)) {
+        return false;
+      }
+
+      auto const & exp = expected[level];
+      if (!std::get<0>(h_bits[y]).and_equals(used, std::get<0>(exp))) {
+        return false;
+      }
+      if constexpr (is_directed_v<G>) {
+        if (!std::get<1>(h_bits[y]).and_equals(used, std::get<1>(exp))) {
+          return false;
+        }
+      }
+
+      for (auto u : std::get<0>(earlier_neighbours[level])) {
+        if (!edge_equiv(g, x, u, h, y, map[u])) {
+          return false;
+        }
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto u : std::get<1>(earlier_neighbours[level])) {
+          if (!edge_equiv(g, u, x, h, map[u], y)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_BACKTRACKING_BITPARALLEL_IND_H_
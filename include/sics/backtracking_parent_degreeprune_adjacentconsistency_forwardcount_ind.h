@@ -9,6 +9,7 @@
 #include "graph_utilities.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
+#include "parent_candidates.h"
 
 #include "stats.h"
 
@@ -123,6 +124,8 @@ void backtracking_parent_degreeprune_adjacentconsistency_forwardcount_ind(
         IndexH>;
     std::vector<h_count_type> h_count;
 
+    parent_candidates<G, H, VertexEquiv> candidates;
+
     explorer(
         G const & g,
         H const & h,
@@ -144,7 +147,8 @@ void backtracking_parent_degreeprune_adjacentconsistency_forwardcount_ind(
           inv(n, m),
           parents(m),
           g_count(m),
-          h_count(n) {
+          h_count(n),
+          candidates(g, h) {
       build_parents();
       build_g_count();
     }
@@ -176,7 +180,7 @@ void backtracking_parent_degreeprune_adjacentconsistency_forwardcount_ind(
             }
           }
         } else {
-          for (auto he : get_parent_edges(p)) {
+          for (auto he : get_parent_edges(x, p)) {
             // TODO maybe add edge_equiv() check for parent
             auto y = he.target;
             if (consistency(x, y)) {
@@ -200,15 +204,11 @@ void backtracking_parent_degreeprune_adjacentconsistency_forwardcount_ind(
       }
     }
 
-    auto get_parent_edges(parent_type p) {
+    auto get_parent_edges(IndexG x, parent_type p) {
       if constexpr (is_directed_v<H>) {
-        if (std::get<1>(p)) {
-          return h.out_edges(map[std::get<0>(p)]);
-        } else {
-          return h.in_edges(map[std::get<0>(p)]);
-        }
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
       } else {
-        return h.edges(map[std::get<0>(p)]);
+        return candidates.edges(x, map[std::get<0>(p)]);
       }
     }
 
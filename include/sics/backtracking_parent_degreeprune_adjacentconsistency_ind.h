@@ -8,6 +8,7 @@
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
+#include "parent_candidates.h"
 
 #include "stats.h"
 
@@ -88,6 +89,8 @@ void backtracking_parent_degreeprune_adjacentconsistency_ind(
       }
     }
 
+    parent_candidates<G, H, VertexEquiv> candidates;
+
     explorer(
         G const & g,
         H const & h,
@@ -107,7 +110,8 @@ void backtracking_parent_degreeprune_adjacentconsistency_ind(
           x_it(std::cbegin(index_order_g)),
           map(m, n),
           inv(n, m),
-          parents(m) {
+          parents(m),
+          candidates(g, h) {
       build_parents();
     }
 
@@ -136,7 +140,7 @@ void backtracking_parent_degreeprune_adjacentconsistency_ind(
             }
           }
         } else {
-          for (auto he : get_parent_edges(p)) {
+          for (auto he : get_parent_edges(x, p)) {
             // TODO maybe add edge_equiv() check for parent
             auto y = he.target;
             if (consistency(x, y)) {
@@ -158,15 +162,11 @@ void backtracking_parent_degreeprune_adjacentconsistency_ind(
       }
     }
 
-    auto get_parent_edges(parent_type p) {
+    auto get_parent_edges(IndexG x, parent_type p) {
       if constexpr (is_directed_v<H>) {
-        if (std::get<1>(p)) {
-          return h.out_edges(map[std::get<0>(p)]);
-        } else {
-          return h.in_edges(map[std::get<0>(p)]);
-        }
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
       } else {
-        return h.edges(map[std::get<0>(p)]);
+        return candidates.edges(x, map[std::get<0>(p)]);
       }
     }
 
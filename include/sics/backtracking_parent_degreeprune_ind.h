@@ -8,6 +8,8 @@
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
+#include "parent_candidates.h"
+#include "value_order.h"
 
 #include "stats.h"
 
@@ -19,14 +21,17 @@ template <
     typename Callback,
     typename IndexOrderG,
     typename VertexEquiv = default_vertex_label_equiv<G, H>,
-    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename ValueOrder = natural_value_order>
 void backtracking_parent_degreeprune_ind(
     G const & g,
     H const & h,
     Callback const & callback,
     IndexOrderG const & index_order_g,
     VertexEquiv const & vertex_equiv = VertexEquiv(),
-    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+    EdgeEquiv const & edge_equiv = EdgeEquiv(),
+    ValueOrder const & value_order = ValueOrder()) {
+  static_assert(!ValueOrder::uses_removals, "backtracking_parent_degreeprune_ind has no future domains");
 
   using IndexG = typename G::index_type;
   using IndexH = typename H::index_type;
@@ -87,13 +92,19 @@ void backtracking_parent_degreeprune_ind(
       }
     }
 
+    parent_candidates<G, H, VertexEquiv> candidates;
+
+    typename ValueOrder::template ranker<G, H> value_rank;
+    std::vector<std::vector<IndexH>> ordered;
+
     explorer(
         G const & g,
         H const & h,
         Callback const & callback,
         IndexOrderG const & index_order_g,
         VertexEquiv const & vertex_equiv,
-        EdgeEquiv const & edge_equiv)
+        EdgeEquiv const & edge_equiv,
+        ValueOrder const & value_order)
         : g{g},
           h{h},
           callback{callback},
@@ -105,7 +116,10 @@ void backtracking_parent_degreeprune_ind(
           n{h.num_vertices()},
           x_it(std::cbegin(index_order_g)),
           map(m, n),
-          parents(m) {
+          parents(m),
+          candidates(g, h),
+          value_rank(value_order, g, h),
+          ordered(m) {
       build_parents();
     }
 
@@ -118,29 +132,46 @@ void backtracking_parent_degreeprune_ind(
         bool proceed = true;
 
         parent_type p = parents[x];
-        if (std::get<0>(p) == m) {
+        if constexpr (ValueOrder::is_ordered) {
+          auto & ys = ordered[std::distance(std::cbegin(index_order_g), x_it)];
+          ys.clear();
+          if (std::get<0>(p) == m) {
+            for (IndexH y=0; y<n; ++y) {
+              if (consistency(y)) {
+                ys.push_back(y);
+              }
+            }
+          } else {
+            for (auto he : get_parent_edges(x, p)) {
+              if (consistency(he.target)) {
+                ys.push_back(he.target);
+              }
+            }
+          }
+          order_values(value_rank, ys, [](IndexH) {
+            return 0;
+          });
+          for (auto y : ys) {
+            proceed = extend(x, y);
+            if (!proceed) {
+              break;
+            }
+          }
+        } else if (std::get<0>(p) == m) {
           for (IndexH y=0; y<n; ++y) {
             if (consistency(y)) {
-              map[x] = y;
-              ++x_it;
-              proceed = explore();
-              --x_it;
-              map[x] = n;
+              proceed = extend(x, y);
               if (!proceed) {
                 break;
               }
             }
           }
         } else {
-          for (auto he : get_parent_edges(p)) {
+          for (auto he : get_parent_edges(x, p)) {
             // TODO maybe add edge_equiv() check for parent
             auto y = he.target;
             if (consistency(y)) {
-              map[x] = y;
-              ++x_it;
-              proceed = explore();
-              --x_it;
-              map[x] = n;
+              proceed = extend(x, y);
               if (!proceed) {
                 break;
               }
@@ -152,15 +183,20 @@ void backtracking_parent_degreeprune_ind(
       }
     }
 
-    auto get_parent_edges(parent_type p) {
+    bool extend(IndexG x, IndexH y) {
+      map[x] = y;
+      ++x_it;
+      bool proceed = explore();
+      --x_it;
+      map[x] = n;
+      return proceed;
+    }
+
+    auto get_parent_edges(IndexG x, parent_type p) {
       if constexpr (is_directed_v<H>) {
-        if (std::get<1>(p)) {
-          return h.out_edges(map[std::get<0>(p)]);
-        } else {
-          return h.in_edges(map[std::get<0>(p)]);
-        }
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
       } else {
-        return h.edges(map[std::get<0>(p)]);
+        return candidates.edges(x, map[std::get<0>(p)]);
       }
     }
 
@@ -194,7 +230,7 @@ void backtracking_parent_degreeprune_ind(
       }
       return true;
     }
-  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv, value_order);
 
   e.explore();
 }
@@ -0,0 +1,333 @@
+#ifndef SICS_BACKTRACKING_PARENT_NEC_DEGREEPRUNE_IND_H_
+#define SICS_BACKTRACKING_PARENT_NEC_DEGREEPRUNE_IND_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "neighbourhood_equivalence.h"
+#include "parent_candidates.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// Like backtracking_parent_degreeprune_ind, but over the neighbourhood
+// equivalence classes of g (see neighbourhood_equivalence.h) instead of its
+// vertices.  A class of k vertices is a single search node: it gets a
+// k-subset of the candidates of its first vertex, chosen in increasing
+// order, pairwise non-adjacent and not taken.  The members are
+// interchangeable, so each complete choice stands for the product of k!
+// over the classes of embeddings, and the search never branches over the
+// permutations.  Classes are ordered by their first vertex in
+// index_order_g.
+//
+// backtracking_parent_nec_degreeprune_ind calls callback once per
+// embedding; backtracking_parent_nec_degreeprune_count_ind returns the
+// number of embeddings.
+namespace backtracking_parent_nec_degreeprune_impl {
+
+// Calls emit(k) for every k embeddings found; stops when it returns false.
+template <
+    typename G,
+    typename H,
+    typename Emit,
+    typename IndexOrderG,
+    typename VertexEquiv,
+    typename EdgeEquiv>
+void explore(
+    G const & g,
+    H const & h,
+    Emit const & emit,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv,
+    EdgeEquiv const & edge_equiv) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Emit const & emit;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    // the classes in search order, and the product of k! over them
+    std::vector<std::vector<IndexG>> classes;
+    std::uintmax_t permutations;
+    void build_classes(
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv) {
+      auto unordered = neighbourhood_equivalence_classes(g, h, vertex_equiv, edge_equiv);
+      std::vector<std::size_t> class_of(m);
+      for (std::size_t c=0; c<unordered.size(); ++c) {
+        for (auto u : unordered[c]) {
+          class_of[u] = c;
+        }
+      }
+      std::vector<bool> done(unordered.size(), false);
+      for (auto u : index_order_g) {
+        auto c = class_of[u];
+        if (!done[c]) {
+          done[c] = true;
+          classes.push_back(std::move(unordered[c]));
+          for (IndexG i=2; i<=classes.back().size(); ++i) {
+            permutations *= i;
+          }
+        }
+      }
+    }
+
+    std::size_t level;
+
+    std::vector<IndexH> map;
+    std::vector<IndexG> inv;
+    // the mapped vertices, in the order they were mapped
+    std::vector<IndexG> mapped;
+
+    using parent_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<IndexG, bool>,
+        std::tuple<IndexG>>;
+    std::vector<parent_type> parents;
+    void build_parents() {
+      for (IndexG u=0; u<m; ++u) {
+        std::get<0>(parents[u]) = m;
+      }
+      std::vector<bool> done(m, false);
+      for (auto const & c : classes) {
+        auto u = c.front();
+        for (auto w : c) {
+          done[w] = true;
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto oe : g.out_edges(u)) {
+            auto i = oe.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u, true};
+            }
+          }
+          for (auto ie : g.in_edges(u)) {
+            auto i = ie.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u, false};
+            }
+          }
+        } else {
+          for (auto e : g.edges(u)) {
+            auto i = e.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u};
+            }
+          }
+        }
+      }
+    }
+
+    parent_candidates<G, H, VertexEquiv> candidates;
+
+    // per level, the candidates of the first vertex of the class
+    std::vector<std::vector<IndexH>> class_candidates;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Emit const & emit,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          emit{emit},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          permutations{1},
+          level{0},
+          map(m, n),
+          inv(n, m),
+          parents(m),
+          candidates(g, h) {
+      build_classes(index_order_g, vertex_equiv, edge_equiv);
+      build_parents();
+      class_candidates.resize(classes.size());
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == classes.size()) {
+        return emit(permutations);
+      } else {
+        auto x = classes[level].front();
+        auto & C = class_candidates[level];
+        C.clear();
+
+        parent_type p = parents[x];
+        if (std::get<0>(p) == m) {
+          for (IndexH y=0; y<n; ++y) {
+            if (consistency(x, y)) {
+              C.push_back(y);
+            }
+          }
+        } else {
+          for (auto he : get_parent_edges(x, p)) {
+            if (consistency(x, he.target)) {
+              C.push_back(he.target);
+            }
+          }
+        }
+
+        return choose(0, 0);
+      }
+    }
+
+    // maps the i-th vertex of the class at this level and the ones after it
+    // to candidates from position from on
+    bool choose(std::size_t i, std::size_t from) {
+      auto const & c = classes[level];
+      if (i == c.size()) {
+        ++level;
+        bool proceed = explore();
+        --level;
+        return proceed;
+      }
+      auto const & C = class_candidates[level];
+      for (auto j=from; j+(c.size()-i)<=C.size(); ++j) {
+        auto y = C[j];
+        if (inv[y] == m && independent(i, y)) {
+          map[c[i]] = y;
+          inv[y] = c[i];
+          mapped.push_back(c[i]);
+          bool proceed = choose(i + 1, j + 1);
+          mapped.pop_back();
+          inv[y] = m;
+          map[c[i]] = n;
+          if (!proceed) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    // whether y is adjacent to none of the images of the first i vertices
+    // of the class at this level
+    bool independent(std::size_t i, IndexH y) {
+      auto const & c = classes[level];
+      for (std::size_t k=0; k<i; ++k) {
+        auto v = map[c[k]];
+        if (h.edge(y, v)) {
+          return false;
+        }
+        if constexpr (is_directed_v<H>) {
+          if (h.edge(v, y)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    auto get_parent_edges(IndexG x, parent_type p) {
+      if constexpr (is_directed_v<H>) {
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
+      } else {
+        return candidates.edges(x, map[std::get<0>(p)]);
+      }
+    }
+
+    // y is a candidate for x given the images of the earlier classes
+    bool consistency(IndexG x, IndexH y) {
+      if (inv[y] != m ||
+          !vertex_equiv(g, x, h, y) ||
+          !degree_condition(g, x, h, y)) {
+        return false;
+      }
+      for (auto u : mapped) {
+        auto v = map[u];
+        auto x_out = g.edge(x, u);
+        if (x_out != h.edge(y, v) || (x_out && !edge_equiv(g, x, u, h, y, v))) {
+          return false;
+        }
+        if constexpr (is_directed_v<G>) {
+          auto x_in = g.edge(u, x);
+          if (x_in != h.edge(v, y) || (x_in && !edge_equiv(g, u, x, h, v, y))) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  } e(g, h, emit, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace backtracking_parent_nec_degreeprune_impl
+
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void backtracking_parent_nec_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  auto emit = [&callback](std::uintmax_t k) {
+    for (std::uintmax_t i=0; i<k; ++i) {
+      if (!callback()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  backtracking_parent_nec_degreeprune_impl::explore(g, h, emit, index_order_g, vertex_equiv, edge_equiv);
+}
+
+template <
+    typename G,
+    typename H,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+std::uintmax_t backtracking_parent_nec_degreeprune_count_ind(
+    G const & g,
+    H const & h,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  std::uintmax_t count = 0;
+  auto emit = [&count](std::uintmax_t k) {
+    count += k;
+    return true;
+  };
+  backtracking_parent_nec_degreeprune_impl::explore(g, h, emit, index_order_g, vertex_equiv, edge_equiv);
+  return count;
+}
+
+}  // namespace sics
+
+#endif  // SICS_BACKTRACKING_PARENT_NEC_DEGREEPRUNE_IND_H_
@@ -0,0 +1,327 @@
+#ifndef SICS_BITSET_KERNELS_H_
+#define SICS_BITSET_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(SICS_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SICS_BITSET_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace sics {
+
+// Fused word-array kernels for the bitset engines.  Every *_any and *_count
+// kernel stores its result in dst and reports on it in the same pass, so a
+// domain row is only read and written once per forward-checking step.
+//
+// default_bitset_kernels() picks the widest implementation the CPU supports
+// at run time (AVX-512, AVX2 or portable scalar code).  Defining
+// SICS_NO_SIMD restricts it to the scalar kernels.
+struct bitset_kernels {
+  using block_type = std::uint64_t;
+  using size_type = std::size_t;
+
+  // dst &= src, returns dst.any()
+  bool (*and_any)(block_type * dst, block_type const * src, size_type n);
+  // dst &= ~src, returns dst.any()
+  bool (*and_not_any)(block_type * dst, block_type const * src, size_type n);
+  // dst &= src, returns dst.count()
+  size_type (*and_count)(block_type * dst, block_type const * src, size_type n);
+  // dst &= ~src, returns dst.count()
+  size_type (*and_not_count)(block_type * dst, block_type const * src, size_type n);
+  // dst |= src, returns dst.count()
+  size_type (*or_count)(block_type * dst, block_type const * src, size_type n);
+  // returns src.count()
+  size_type (*count)(block_type const * src, size_type n);
+};
+
+namespace bitset_kernels_impl {
+
+using block_type = bitset_kernels::block_type;
+using size_type = bitset_kernels::size_type;
+
+#ifdef SICS_BITSET_KERNELS_X86
+#define SICS_TARGET_AVX2 __attribute__((target("avx2")))
+#define SICS_TARGET_AVX512 __attribute__((target("avx512f")))
+#define SICS_TARGET_AVX512_POPCNT __attribute__((target("avx512f,avx512vpopcntdq")))
+#endif
+
+struct and_op {
+  static block_type scalar(block_type a, block_type b) {
+    return a & b;
+  }
+#ifdef SICS_BITSET_KERNELS_X86
+  SICS_TARGET_AVX2 static __m256i avx2(__m256i a, __m256i b) {
+    return _mm256_and_si256(a, b);
+  }
+  SICS_TARGET_AVX512 static __m512i avx512(__m512i a, __m512i b) {
+    return _mm512_and_si512(a, b);
+  }
+#endif
+};
+
+struct and_not_op {
+  static block_type scalar(block_type a, block_type b) {
+    return a & ~b;
+  }
+#ifdef SICS_BITSET_KERNELS_X86
+  SICS_TARGET_AVX2 static __m256i avx2(__m256i a, __m256i b) {
+    return _mm256_andnot_si256(b, a);
+  }
+  SICS_TARGET_AVX512 static __m512i avx512(__m512i a, __m512i b) {
+    // not _mm512_andnot_si512, which trips -Wmaybe-uninitialized in some GCC
+    // versions
+    return _mm512_and_si512(a, _mm512_xor_si512(b, _mm512_set1_epi64(-1)));
+  }
+#endif
+};
+
+struct or_op {
+  static block_type scalar(block_type a, block_type b) {
+    return a | b;
+  }
+#ifdef SICS_BITSET_KERNELS_X86
+  SICS_TARGET_AVX2 static __m256i avx2(__m256i a, __m256i b) {
+    return _mm256_or_si256(a, b);
+  }
+  SICS_TARGET_AVX512 static __m512i avx512(__m512i a, __m512i b) {
+    return _mm512_or_si512(a, b);
+  }
+#endif
+};
+
+// scalar
+
+template <typename Op>
+bool combine_any_scalar(block_type * dst, block_type const * src, size_type n) {
+  block_type acc = 0;
+  for (size_type i=0; i<n; ++i) {
+    dst[i] = Op::scalar(dst[i], src[i]);
+    acc |= dst[i];
+  }
+  return acc != 0;
+}
+
+template <typename Op>
+size_type combine_count_scalar(block_type * dst, block_type const * src, size_type n) {
+  size_type result = 0;
+  for (size_type i=0; i<n; ++i) {
+    dst[i] = Op::scalar(dst[i], src[i]);
+    result += __builtin_popcountll(dst[i]);
+  }
+  return result;
+}
+
+inline size_type count_scalar(block_type const * src, size_type n) {
+  size_type result = 0;
+  for (size_type i=0; i<n; ++i) {
+    result += __builtin_popcountll(src[i]);
+  }
+  return result;
+}
+
+#ifdef SICS_BITSET_KERNELS_X86
+
+// AVX2
+
+// Per 64-bit lane popcount (nibble lookup, Mula et al.).
+SICS_TARGET_AVX2 inline __m256i popcount_avx2(__m256i v) {
+  auto const lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  auto const low_mask = _mm256_set1_epi8(0x0f);
+  auto lo = _mm256_and_si256(v, low_mask);
+  auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  auto bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+SICS_TARGET_AVX2 inline size_type horizontal_sum_avx2(__m256i v) {
+  return static_cast<size_type>(_mm256_extract_epi64(v, 0)) +
+         static_cast<size_type>(_mm256_extract_epi64(v, 1)) +
+         static_cast<size_type>(_mm256_extract_epi64(v, 2)) +
+         static_cast<size_type>(_mm256_extract_epi64(v, 3));
+}
+
+template <typename Op>
+SICS_TARGET_AVX2 bool combine_any_avx2(block_type * dst, block_type const * src, size_type n) {
+  auto acc = _mm256_setzero_si256();
+  size_type i = 0;
+  for (; i+4<=n; i+=4) {
+    auto d = reinterpret_cast<__m256i *>(dst + i);
+    auto s = reinterpret_cast<__m256i const *>(src + i);
+    auto r = Op::avx2(_mm256_loadu_si256(d), _mm256_loadu_si256(s));
+    _mm256_storeu_si256(d, r);
+    acc = _mm256_or_si256(acc, r);
+  }
+  block_type tail = 0;
+  for (; i<n; ++i) {
+    dst[i] = Op::scalar(dst[i], src[i]);
+    tail |= dst[i];
+  }
+  return !_mm256_testz_si256(acc, acc) || tail != 0;
+}
+
+template <typename Op>
+SICS_TARGET_AVX2 size_type combine_count_avx2(block_type * dst, block_type const * src, size_type n) {
+  auto acc = _mm256_setzero_si256();
+  size_type i = 0;
+  for (; i+4<=n; i+=4) {
+    auto d = reinterpret_cast<__m256i *>(dst + i);
+    auto s = reinterpret_cast<__m256i const *>(src + i);
+    auto r = Op::avx2(_mm256_loadu_si256(d), _mm256_loadu_si256(s));
+    _mm256_storeu_si256(d, r);
+    acc = _mm256_add_epi64(acc, popcount_avx2(r));
+  }
+  auto result = horizontal_sum_avx2(acc);
+  for (; i<n; ++i) {
+    dst[i] = Op::scalar(dst[i], src[i]);
+    result += __builtin_popcountll(dst[i]);
+  }
+  return result;
+}
+
+SICS_TARGET_AVX2 inline size_type count_avx2(block_type const * src, size_type n) {
+  auto acc = _mm256_setzero_si256();
+  size_type i = 0;
+  for (; i+4<=n; i+=4) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + i));
+    acc = _mm256_add_epi64(acc, popcount_avx2(v));
+  }
+  auto result = horizontal_sum_avx2(acc);
+  for (; i<n; ++i) {
+    result += __builtin_popcountll(src[i]);
+  }
+  return result;
+}
+
+// AVX-512
+
+SICS_TARGET_AVX512 inline size_type horizontal_sum_avx512(__m512i v) {
+  alignas(64) block_type lanes[8];
+  _mm512_store_si512(lanes, v);
+  size_type result = 0;
+  for (auto lane : lanes) {
+    result += lane;
+  }
+  return result;
+}
+
+template <typename Op>
+SICS_TARGET_AVX512 bool combine_any_avx512(block_type * dst, block_type const * src, size_type n) {
+  auto acc = _mm512_setzero_si512();
+  size_type i = 0;
+  for (; i+8<=n; i+=8) {
+    auto r = Op::avx512(_mm512_loadu_si512(dst + i), _mm512_loadu_si512(src + i));
+    _mm512_storeu_si512(dst + i, r);
+    acc = _mm512_or_si512(acc, r);
+  }
+  if (i < n) {
+    __mmask8 tail = (1u << (n - i)) - 1;
+    auto r = Op::avx512(_mm512_maskz_loadu_epi64(tail, dst + i), _mm512_maskz_loadu_epi64(tail, src + i));
+    _mm512_mask_storeu_epi64(dst + i, tail, r);
+    acc = _mm512_or_si512(acc, r);
+  }
+  return _mm512_test_epi64_mask(acc, acc) != 0;
+}
+
+template <typename Op>
+SICS_TARGET_AVX512_POPCNT size_type combine_count_avx512(block_type * dst, block_type const * src, size_type n) {
+  auto acc = _mm512_setzero_si512();
+  size_type i = 0;
+  for (; i+8<=n; i+=8) {
+    auto r = Op::avx512(_mm512_loadu_si512(dst + i), _mm512_loadu_si512(src + i));
+    _mm512_storeu_si512(dst + i, r);
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(r));
+  }
+  if (i < n) {
+    __mmask8 tail = (1u << (n - i)) - 1;
+    auto r = Op::avx512(_mm512_maskz_loadu_epi64(tail, dst + i), _mm512_maskz_loadu_epi64(tail, src + i));
+    _mm512_mask_storeu_epi64(dst + i, tail, r);
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(r));
+  }
+  return horizontal_sum_avx512(acc);
+}
+
+SICS_TARGET_AVX512_POPCNT inline size_type count_avx512(block_type const * src, size_type n) {
+  auto acc = _mm512_setzero_si512();
+  size_type i = 0;
+  for (; i+8<=n; i+=8) {
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(src + i)));
+  }
+  if (i < n) {
+    __mmask8 tail = (1u << (n - i)) - 1;
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(tail, src + i)));
+  }
+  return horizontal_sum_avx512(acc);
+}
+
+#undef SICS_TARGET_AVX2
+#undef SICS_TARGET_AVX512
+#undef SICS_TARGET_AVX512_POPCNT
+
+#endif  // SICS_BITSET_KERNELS_X86
+
+}  // namespace bitset_kernels_impl
+
+inline bitset_kernels const & scalar_bitset_kernels() {
+  using namespace bitset_kernels_impl;
+  static bitset_kernels const kernels{
+      combine_any_scalar<and_op>,
+      combine_any_scalar<and_not_op>,
+      combine_count_scalar<and_op>,
+      combine_count_scalar<and_not_op>,
+      combine_count_scalar<or_op>,
+      count_scalar};
+  return kernels;
+}
+
+#ifdef SICS_BITSET_KERNELS_X86
+
+inline bitset_kernels const & avx2_bitset_kernels() {
+  using namespace bitset_kernels_impl;
+  static bitset_kernels const kernels{
+      combine_any_avx2<and_op>,
+      combine_any_avx2<and_not_op>,
+      combine_count_avx2<and_op>,
+      combine_count_avx2<and_not_op>,
+      combine_count_avx2<or_op>,
+      count_avx2};
+  return kernels;
+}
+
+// Requires AVX512VPOPCNTDQ in addition to AVX512F.
+inline bitset_kernels const & avx512_bitset_kernels() {
+  using namespace bitset_kernels_impl;
+  static bitset_kernels const kernels{
+      combine_any_avx512<and_op>,
+      combine_any_avx512<and_not_op>,
+      combine_count_avx512<and_op>,
+      combine_count_avx512<and_not_op>,
+      combine_count_avx512<or_op>,
+      count_avx512};
+  return kernels;
+}
+
+#endif  // SICS_BITSET_KERNELS_X86
+
+inline bitset_kernels const & default_bitset_kernels() {
+  static bitset_kernels const & kernels = []() -> bitset_kernels const & {
+#ifdef SICS_BITSET_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+      return avx512_bitset_kernels();
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return avx2_bitset_kernels();
+    }
+#endif
+    return scalar_bitset_kernels();
+  }();
+  return kernels;
+}
+
+}  // namespace sics
+
+#endif  // SICS_BITSET_KERNELS_H_
@@ -0,0 +1,61 @@
+#ifndef SICS_BITSET_OPERATIONS_H_
+#define SICS_BITSET_OPERATIONS_H_
+
+#include <type_traits>
+#include <utility>
+
+namespace sics {
+
+// Fused in-place bitset operations for engines templated on the bitset type.
+// Types with the fused members of block_bitset (block_bitset, fixed_bitset)
+// do the operation and the test or count in a single pass over the blocks;
+// other types such as boost::dynamic_bitset<> fall back to two passes.
+
+template <typename Bitset, typename = void>
+struct has_fused_bitset_operations : std::false_type {};
+
+template <typename Bitset>
+struct has_fused_bitset_operations<
+    Bitset,
+    std::void_t<decltype(std::declval<Bitset &>().and_any(std::declval<Bitset const &>()))>>
+    : std::true_type {};
+
+template <typename Bitset>
+inline constexpr bool has_fused_bitset_operations_v = has_fused_bitset_operations<Bitset>::value;
+
+// a &= b; return a.any()
+template <typename Bitset>
+bool bitset_and_any(Bitset & a, Bitset const & b) {
+  if constexpr (has_fused_bitset_operations_v<Bitset>) {
+    return a.and_any(b);
+  } else {
+    a &= b;
+    return a.any();
+  }
+}
+
+// a -= b; return a.any()
+template <typename Bitset>
+bool bitset_and_not_any(Bitset & a, Bitset const & b) {
+  if constexpr (has_fused_bitset_operations_v<Bitset>) {
+    return a.and_not_any(b);
+  } else {
+    a -= b;
+    return a.any();
+  }
+}
+
+// a |= b; return a.count()
+template <typename Bitset>
+auto bitset_or_count(Bitset & a, Bitset const & b) {
+  if constexpr (has_fused_bitset_operations_v<Bitset>) {
+    return a.or_count(b);
+  } else {
+    a |= b;
+    return a.count();
+  }
+}
+
+}  // namespace sics
+
+#endif  // SICS_BITSET_OPERATIONS_H_
@@ -0,0 +1,212 @@
+#ifndef SICS_BLOCK_BITSET_H_
+#define SICS_BLOCK_BITSET_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+#include "bitset_kernels.h"
+
+namespace sics {
+
+// A dense bitset with the interface of boost::dynamic_bitset<> used by the
+// bitset engines, plus fused operations backed by bitset_kernels.
+// Bits past size() are always zero.
+class block_bitset {
+ public:
+  using block_type = bitset_kernels::block_type;
+  using size_type = bitset_kernels::size_type;
+
+  static constexpr size_type bits_per_block = 64;
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+ private:
+  size_type m_num_bits;
+  std::vector<block_type> m_blocks;
+
+  static size_type block_index(size_type pos) {
+    return pos / bits_per_block;
+  }
+
+  static size_type bit_index(size_type pos) {
+    return pos % bits_per_block;
+  }
+
+  static size_type num_blocks_for(size_type num_bits) {
+    return (num_bits + bits_per_block - 1) / bits_per_block;
+  }
+
+  static bitset_kernels const & kernels() {
+    return default_bitset_kernels();
+  }
+
+  size_type find_from_block(size_type b) const {
+    for (; b<m_blocks.size(); ++b) {
+      if (m_blocks[b]) {
+        return b * bits_per_block + __builtin_ctzll(m_blocks[b]);
+      }
+    }
+    return npos;
+  }
+
+ public:
+  block_bitset()
+      : m_num_bits{0} {
+  }
+
+  explicit block_bitset(size_type num_bits)
+      : m_num_bits{num_bits},
+        m_blocks(num_blocks_for(num_bits), 0) {
+  }
+
+  void resize(size_type num_bits) {
+    m_blocks.resize(num_blocks_for(num_bits), 0);
+    if (num_bits < m_num_bits && bit_index(num_bits) != 0) {
+      m_blocks.back() &= ~(~block_type{0} << bit_index(num_bits));
+    }
+    m_num_bits = num_bits;
+  }
+
+  size_type size() const {
+    return m_num_bits;
+  }
+
+  size_type num_blocks() const {
+    return m_blocks.size();
+  }
+
+  block_type const * data() const {
+    return m_blocks.data();
+  }
+
+  block_type * data() {
+    return m_blocks.data();
+  }
+
+  bool test(size_type pos) const {
+    return (m_blocks[block_index(pos)] >> bit_index(pos)) & 1;
+  }
+
+  bool operator[](size_type pos) const {
+    return test(pos);
+  }
+
+  block_bitset & set(size_type pos) {
+    m_blocks[block_index(pos)] |= block_type{1} << bit_index(pos);
+    return *this;
+  }
+
+  block_bitset & set() {
+    std::fill(m_blocks.begin(), m_blocks.end(), ~block_type{0});
+    if (bit_index(m_num_bits) != 0) {
+      m_blocks.back() &= ~(~block_type{0} << bit_index(m_num_bits));
+    }
+    return *this;
+  }
+
+  block_bitset & reset(size_type pos) {
+    m_blocks[block_index(pos)] &= ~(block_type{1} << bit_index(pos));
+    return *this;
+  }
+
+  block_bitset & reset() {
+    std::fill(m_blocks.begin(), m_blocks.end(), 0);
+    return *this;
+  }
+
+  bool any() const {
+    return std::any_of(m_blocks.cbegin(), m_blocks.cend(), [](auto block) {
+      return block != 0;
+    });
+  }
+
+  bool none() const {
+    return !any();
+  }
+
+  size_type count() const {
+    return kernels().count(data(), num_blocks());
+  }
+
+  size_type find_first() const {
+    return find_from_block(0);
+  }
+
+  size_type find_next(size_type pos) const {
+    ++pos;
+    if (pos >= m_num_bits) {
+      return npos;
+    }
+    auto b = block_index(pos);
+    auto rest = m_blocks[b] & (~block_type{0} << bit_index(pos));
+    if (rest) {
+      return b * bits_per_block + __builtin_ctzll(rest);
+    }
+    return find_from_block(b + 1);
+  }
+
+  block_bitset & operator&=(block_bitset const & other) {
+    and_any(other);
+    return *this;
+  }
+
+  block_bitset & operator|=(block_bitset const & other) {
+    or_count(other);
+    return *this;
+  }
+
+  // Set difference, *this & ~other.
+  block_bitset & operator-=(block_bitset const & other) {
+    and_not_any(other);
+    return *this;
+  }
+
+  // *this &= other; return any()
+  bool and_any(block_bitset const & other) {
+    return kernels().and_any(data(), other.data(), num_blocks());
+  }
+
+  // *this &= ~other; return any()
+  bool and_not_any(block_bitset const & other) {
+    return kernels().and_not_any(data(), other.data(), num_blocks());
+  }
+
+  // *this &= other; return count()
+  size_type and_count(block_bitset const & other) {
+    return kernels().and_count(data(), other.data(), num_blocks());
+  }
+
+  // *this &= ~other; return count()
+  size_type and_not_count(block_bitset const & other) {
+    return kernels().and_not_count(data(), other.data(), num_blocks());
+  }
+
+  // *this |= other; return count()
+  size_type or_count(block_bitset const & other) {
+    return kernels().or_count(data(), other.data(), num_blocks());
+  }
+
+  // (*this & mask) == expected
+  bool and_equals(block_bitset const & mask, block_bitset const & expected) const {
+    for (size_type b=0; b<m_blocks.size(); ++b) {
+      if ((m_blocks[b] & mask.m_blocks[b]) != expected.m_blocks[b]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend bool operator==(block_bitset const & a, block_bitset const & b) {
+    return a.m_num_bits == b.m_num_bits && a.m_blocks == b.m_blocks;
+  }
+
+  friend bool operator!=(block_bitset const & a, block_bitset const & b) {
+    return !(a == b);
+  }
+};
+
+}  // namespace sics
+
+#endif  // SICS_BLOCK_BITSET_H_
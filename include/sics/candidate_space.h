@@ -0,0 +1,298 @@
+#ifndef SICS_CANDIDATE_SPACE_H_
+#define SICS_CANDIDATE_SPACE_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+
+namespace sics {
+
+// A candidate space in the style of CPI and CECI, built once before the
+// search.
+//
+// The vertices of g are ordered breadth-first, each component from the
+// vertex with the fewest candidates per neighbour.  Every vertex u starts
+// with the vertices of h that pass vertex_equiv and degree_condition.  The
+// sets are then refined top-down: along the order, the candidates of u with
+// no compatible neighbour among the candidates of an earlier neighbour of u
+// are removed.  A bottom-up pass in reverse order does the same against the
+// later neighbours.  Compatible means the edges between the two pairs agree
+// in both directions, with equivalent labels.
+//
+// The candidates of u are kept sorted.  For every edge between u and an
+// earlier neighbour w (the BFS parent of u first), the index stores which
+// candidates of u are compatible with each candidate of w.  These are sorted
+// lists of positions in candidates(u), in CSR form.  So the candidates of u
+// consistent with the images of all its earlier neighbours are the
+// intersection of one list per neighbour, and an engine walking the index
+// never has to look at the edges of h or check a label.
+template <
+    typename G,
+    typename H,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+class candidate_space {
+ public:
+  using index_g_type = typename G::index_type;
+  using index_h_type = typename H::index_type;
+
+ private:
+  G const & g;
+  H const & h;
+
+  vertex_equiv_helper<VertexEquiv> vertex_equiv;
+  edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+  index_g_type m;
+  index_h_type n;
+
+  std::vector<index_g_type> m_order;
+  std::vector<index_g_type> m_position;
+  std::vector<index_g_type> m_parents;
+
+  // sorted neighbours of u in either direction, and those earlier in the
+  // order, the parent first
+  std::vector<std::vector<index_g_type>> m_neighbours;
+  std::vector<std::vector<index_g_type>> m_backward;
+
+  std::vector<std::vector<index_h_type>> m_candidates;
+
+  struct adjacency {
+    std::vector<std::size_t> offsets;
+    std::vector<index_h_type> targets;
+  };
+  // m_adjacency[u][k]: for the k-th backward neighbour of u
+  std::vector<std::vector<adjacency>> m_adjacency;
+
+  std::vector<char> m_mark;
+
+  void build_neighbours() {
+    for (index_g_type u=0; u<m; ++u) {
+      for (auto oe : edges_or_out_edges(g, u)) {
+        if (oe.target != u) {
+          m_neighbours[u].push_back(oe.target);
+        }
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto ie : g.in_edges(u)) {
+          if (ie.target != u) {
+            m_neighbours[u].push_back(ie.target);
+          }
+        }
+      }
+      std::sort(m_neighbours[u].begin(), m_neighbours[u].end());
+      m_neighbours[u].erase(std::unique(m_neighbours[u].begin(), m_neighbours[u].end()), m_neighbours[u].end());
+    }
+  }
+
+  void build_initial_candidates() {
+    for (index_g_type u=0; u<m; ++u) {
+      for (index_h_type v=0; v<n; ++v) {
+        if (vertex_equiv(g, u, h, v) && degree_condition(g, u, h, v)) {
+          m_candidates[u].push_back(v);
+        }
+      }
+    }
+  }
+
+  void build_order() {
+    // roots: fewest candidates per neighbour first
+    std::vector<index_g_type> roots(m);
+    for (index_g_type u=0; u<m; ++u) {
+      roots[u] = u;
+    }
+    std::stable_sort(roots.begin(), roots.end(), [this](auto a, auto b) {
+      return m_candidates[a].size() * std::max<std::size_t>(m_neighbours[b].size(), 1) <
+             m_candidates[b].size() * std::max<std::size_t>(m_neighbours[a].size(), 1);
+    });
+
+    std::vector<bool> visited(m, false);
+    for (auto r : roots) {
+      if (visited[r]) {
+        continue;
+      }
+      visited[r] = true;
+      auto i = m_order.size();
+      m_order.push_back(r);
+      for (; i<m_order.size(); ++i) {
+        auto u = m_order[i];
+        for (auto w : m_neighbours[u]) {
+          if (!visited[w]) {
+            visited[w] = true;
+            m_parents[w] = u;
+            m_order.push_back(w);
+          }
+        }
+      }
+    }
+  }
+
+  // whether mapping u to v and w to vw agrees on the edges between them
+  bool compatible(index_g_type u, index_g_type w, index_h_type v, index_h_type vw) const {
+    auto out = g.edge(u, w);
+    if (out != h.edge(v, vw) || (out && !edge_equiv(g, u, w, h, v, vw))) {
+      return false;
+    }
+    if constexpr (is_directed_v<G>) {
+      auto in = g.edge(w, u);
+      if (in != h.edge(vw, v) || (in && !edge_equiv(g, w, u, h, vw, v))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // the neighbours of v through which a neighbour w of u can be reached
+  auto h_edges(index_g_type u, index_g_type w, index_h_type v) const {
+    if constexpr (is_directed_v<H>) {
+      return g.edge(u, w) ? h.out_edges(v) : h.in_edges(v);
+    } else {
+      return h.edges(v);
+    }
+  }
+
+  // removes the candidates of u with no compatible candidate of w
+  void refine(index_g_type u, index_g_type w) {
+    for (auto vw : m_candidates[w]) {
+      m_mark[vw] = true;
+    }
+    auto & C = m_candidates[u];
+    C.erase(std::remove_if(C.begin(), C.end(), [this, u, w](auto v) {
+      for (auto he : h_edges(u, w, v)) {
+        if (m_mark[he.target] && compatible(u, w, v, he.target)) {
+          return false;
+        }
+      }
+      return true;
+    }), C.end());
+    for (auto vw : m_candidates[w]) {
+      m_mark[vw] = false;
+    }
+  }
+
+  void build_refinement() {
+    for (auto u : m_order) {
+      for (auto w : m_neighbours[u]) {
+        if (m_position[w] < m_position[u]) {
+          refine(u, w);
+        }
+      }
+    }
+    for (auto it=m_order.crbegin(); it!=m_order.crend(); ++it) {
+      auto u = *it;
+      for (auto w : m_neighbours[u]) {
+        if (m_position[w] > m_position[u]) {
+          refine(u, w);
+        }
+      }
+    }
+  }
+
+  void build_adjacency() {
+    std::vector<index_h_type> index(n, n);
+    for (auto u : m_order) {
+      auto const & C = m_candidates[u];
+      for (index_h_type j=0; j<C.size(); ++j) {
+        index[C[j]] = j;
+      }
+      for (auto w : m_backward[u]) {
+        auto & a = m_adjacency[u].emplace_back();
+        a.offsets.push_back(0);
+        for (auto vw : m_candidates[w]) {
+          auto first = a.targets.size();
+          for (auto he : h_edges(w, u, vw)) {
+            auto v = he.target;
+            if (index[v] != n && compatible(u, w, v, vw)) {
+              a.targets.push_back(index[v]);
+            }
+          }
+          std::sort(std::next(a.targets.begin(), first), a.targets.end());
+          a.offsets.push_back(a.targets.size());
+        }
+      }
+      for (auto v : C) {
+        index[v] = n;
+      }
+    }
+  }
+
+ public:
+  candidate_space(
+      G const & g,
+      H const & h,
+      VertexEquiv const & vertex_equiv = VertexEquiv(),
+      EdgeEquiv const & edge_equiv = EdgeEquiv())
+      : g{g},
+        h{h},
+        vertex_equiv{vertex_equiv},
+        edge_equiv{edge_equiv},
+        m{g.num_vertices()},
+        n{h.num_vertices()},
+        m_position(m),
+        m_parents(m, m),
+        m_neighbours(m),
+        m_backward(m),
+        m_candidates(m),
+        m_adjacency(m),
+        m_mark(n, false) {
+    build_neighbours();
+    build_initial_candidates();
+    build_order();
+    for (index_g_type i=0; i<m; ++i) {
+      m_position[m_order[i]] = i;
+    }
+    for (auto u : m_order) {
+      if (m_parents[u] != m) {
+        m_backward[u].push_back(m_parents[u]);
+      }
+      for (auto w : m_neighbours[u]) {
+        if (w != m_parents[u] && m_position[w] < m_position[u]) {
+          m_backward[u].push_back(w);
+        }
+      }
+    }
+    build_refinement();
+    build_adjacency();
+  }
+
+  // the breadth-first order of g
+  std::vector<index_g_type> const & order() const {
+    return m_order;
+  }
+
+  // the BFS tree parent of u, or num_vertices() for a root
+  index_g_type parent(index_g_type u) const {
+    return m_parents[u];
+  }
+
+  // the neighbours of u earlier in order(), the parent first
+  std::vector<index_g_type> const & backward_neighbours(index_g_type u) const {
+    return m_backward[u];
+  }
+
+  // the sorted candidates of u
+  std::vector<index_h_type> const & candidates(index_g_type u) const {
+    return m_candidates[u];
+  }
+
+  // the positions in candidates(u) of the candidates compatible with
+  // candidates(w)[i], for w = backward_neighbours(u)[k], sorted
+  auto adjacent(index_g_type u, std::size_t k, std::size_t i) const {
+    auto const & a = m_adjacency[u][k];
+    return boost::make_iterator_range(
+        a.targets.data() + a.offsets[i],
+        a.targets.data() + a.offsets[i + 1]);
+  }
+};
+
+}  // namespace sics
+
+#endif  // SICS_CANDIDATE_SPACE_H_
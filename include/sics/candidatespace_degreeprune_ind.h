@@ -0,0 +1,199 @@
+#ifndef SICS_CANDIDATESPACE_DEGREEPRUNE_IND_H_
+#define SICS_CANDIDATESPACE_DEGREEPRUNE_IND_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+#include "candidate_space.h"
+#include "sorted_intersection.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// Enumerates by walking a candidate_space instead of the edges of h, in the
+// breadth-first order of the index.  The candidates of x are the
+// intersection of the lists of the index for the images of its earlier
+// neighbours (all of candidates(x) if it has none), so they already agree
+// with those on vertex labels, degrees, edges and edge labels.  What is left
+// to check is that the image is not taken and, for an induced embedding,
+// that it is not adjacent to the images of the earlier vertices that are
+// not neighbours of x.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void candidatespace_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    candidate_space<G, H, VertexEquiv, EdgeEquiv> space;
+
+    IndexG m;
+    IndexH n;
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+    std::vector<IndexG> inv;
+    // map_index[u]: the position of map[u] in space.candidates(u)
+    std::vector<IndexH> map_index;
+
+    // non_neighbours[l]: the vertices before level l not adjacent to the
+    // vertex at level l
+    std::vector<std::vector<IndexG>> non_neighbours;
+    void build_non_neighbours() {
+      auto const & order = space.order();
+      for (IndexG l=0; l<m; ++l) {
+        auto x = order[l];
+        for (IndexG i=0; i<l; ++i) {
+          auto u = order[i];
+          if (!g.edge(x, u) && !g.edge(u, x)) {
+            non_neighbours[l].push_back(u);
+          }
+        }
+      }
+    }
+
+    // candidates[l]: positions in space.candidates of the vertex at level l
+    std::vector<std::vector<IndexH>> candidates;
+    std::vector<IndexH> scratch;
+    std::vector<std::pair<IndexH const *, std::size_t>> lists;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          space(g, h, vertex_equiv, edge_equiv),
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          level{0},
+          map(m, n),
+          inv(n, m),
+          map_index(m, n),
+          non_neighbours(m),
+          candidates(m) {
+      build_non_neighbours();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = space.order()[level];
+        auto const & C = space.candidates(x);
+        bool proceed = true;
+
+        if (space.backward_neighbours(x).empty()) {
+          for (IndexH j=0; j<C.size(); ++j) {
+            if (consistency(C[j])) {
+              proceed = assign_and_explore(x, j);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        } else {
+          build_candidates();
+          for (auto j : candidates[level]) {
+            if (consistency(C[j])) {
+              proceed = assign_and_explore(x, j);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        }
+
+        return proceed;
+      }
+    }
+
+    bool assign_and_explore(IndexG x, IndexH j) {
+      auto y = space.candidates(x)[j];
+      map[x] = y;
+      map_index[x] = j;
+      inv[y] = x;
+      ++level;
+      bool proceed = explore();
+      --level;
+      inv[y] = m;
+      map_index[x] = n;
+      map[x] = n;
+      return proceed;
+    }
+
+    void build_candidates() {
+      auto x = space.order()[level];
+      auto const & backward = space.backward_neighbours(x);
+
+      lists.clear();
+      for (std::size_t k=0; k<backward.size(); ++k) {
+        auto r = space.adjacent(x, k, map_index[backward[k]]);
+        lists.emplace_back(r.begin(), r.size());
+      }
+      std::sort(lists.begin(), lists.end(), [](auto a, auto b) {
+        return a.second < b.second;
+      });
+
+      auto & result = candidates[level];
+      result.assign(lists.front().first, lists.front().first + lists.front().second);
+      for (auto it=std::next(lists.cbegin()); it!=lists.cend() && !result.empty(); ++it) {
+        scratch.resize(result.size() + sorted_intersection_padding);
+        scratch.resize(sorted_intersection(result.data(), result.size(), it->first, it->second, scratch.data()));
+        std::swap(result, scratch);
+      }
+    }
+
+    bool consistency(IndexH y) {
+      if (inv[y] != m) {
+        return false;
+      }
+      for (auto u : non_neighbours[level]) {
+        auto v = map[u];
+        if (h.edge(y, v)) {
+          return false;
+        }
+        if constexpr (is_directed_v<H>) {
+          if (h.edge(v, y)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  } e(g, h, callback, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_CANDIDATESPACE_DEGREEPRUNE_IND_H_
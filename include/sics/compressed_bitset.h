@@ -0,0 +1,232 @@
+#ifndef SICS_COMPRESSED_BITSET_H_
+#define SICS_COMPRESSED_BITSET_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "hierarchical_bitset.h"
+
+namespace sics {
+
+// An immutable roaring-style bitset.  The bit positions are split into chunks
+// of 2^16 and every non-empty chunk is stored in whichever container is the
+// smallest: a sorted array of the set positions, a 2^16 bit bitmap, or a
+// sorted list of runs.
+//
+// It is meant for adjacency rows of large sparse targets, which are then
+// combined with dense domains through and_assign() and and_not_assign().
+class compressed_bitset {
+ public:
+  using size_type = std::size_t;
+  using block_type = std::uint64_t;
+
+  static constexpr size_type chunk_bits = size_type{1} << 16;
+  static constexpr size_type bits_per_block = 64;
+  static constexpr size_type blocks_per_chunk = chunk_bits / bits_per_block;
+
+ private:
+  enum struct container_kind {
+    array,
+    bitmap,
+    run
+  };
+
+  struct container {
+    container_kind kind;
+    size_type cardinality;
+    // array: the set positions; run: pairs (first, last) flattened
+    std::vector<std::uint16_t> values;
+    // bitmap: blocks_per_chunk blocks
+    std::vector<block_type> blocks;
+  };
+
+  size_type m_num_bits;
+  std::vector<size_type> m_keys;
+  std::vector<container> m_containers;
+
+  static container make_container(std::vector<std::uint16_t> const & values) {
+    size_type num_runs = 0;
+    for (size_type i=0; i<values.size(); ++i) {
+      if (i == 0 || values[i] != values[i-1] + 1) {
+        ++num_runs;
+      }
+    }
+
+    auto array_size = 2 * values.size();
+    auto bitmap_size = 8 * blocks_per_chunk;
+    auto run_size = 4 * num_runs;
+
+    container c;
+    c.cardinality = values.size();
+    if (run_size < array_size && run_size < bitmap_size) {
+      c.kind = container_kind::run;
+      c.values.reserve(2 * num_runs);
+      for (size_type i=0; i<values.size(); ++i) {
+        if (i == 0 || values[i] != values[i-1] + 1) {
+          c.values.push_back(values[i]);
+          c.values.push_back(values[i]);
+        } else {
+          c.values.back() = values[i];
+        }
+      }
+    } else if (array_size <= bitmap_size) {
+      c.kind = container_kind::array;
+      c.values = values;
+    } else {
+      c.kind = container_kind::bitmap;
+      c.blocks.assign(blocks_per_chunk, 0);
+      for (auto v : values) {
+        c.blocks[v / bits_per_block] |= block_type{1} << (v % bits_per_block);
+      }
+    }
+    return c;
+  }
+
+  // The bits of block w (0 <= w < blocks_per_chunk) of container c.  Calls
+  // for the same container must use nondecreasing w and share the cursor.
+  static block_type block_mask(container const & c, size_type w, size_type & cursor) {
+    if (c.kind == container_kind::bitmap) {
+      return c.blocks[w];
+    }
+
+    auto lo = w * bits_per_block;
+    auto hi = lo + bits_per_block;
+    block_type mask = 0;
+    if (c.kind == container_kind::array) {
+      auto begin = std::next(c.values.cbegin(), cursor);
+      cursor = std::distance(c.values.cbegin(), std::lower_bound(begin, c.values.cend(), lo));
+      while (cursor < c.values.size() && c.values[cursor] < hi) {
+        mask |= block_type{1} << (c.values[cursor] - lo);
+        ++cursor;
+      }
+    } else {
+      while (cursor < c.values.size() && c.values[cursor+1] < lo) {
+        cursor += 2;
+      }
+      for (auto r=cursor; r<c.values.size() && c.values[r] < hi; r+=2) {
+        auto first = std::max<size_type>(c.values[r], lo) - lo;
+        auto last = std::min<size_type>(c.values[r+1], hi - 1) - lo;
+        auto width = last - first + 1;
+        auto bits = width == bits_per_block ? ~block_type{0} : ((block_type{1} << width) - 1);
+        mask |= bits << first;
+      }
+    }
+    return mask;
+  }
+
+  template <typename Op>
+  friend void combine_blocks(hierarchical_bitset & dst, compressed_bitset const & row, Op op);
+
+ public:
+  compressed_bitset()
+      : m_num_bits{0} {
+  }
+
+  // [first, last) must list the set positions in increasing order.
+  template <typename InputIt>
+  compressed_bitset(size_type num_bits, InputIt first, InputIt last)
+      : m_num_bits{num_bits} {
+    std::vector<std::uint16_t> values;
+    auto key = size_type{0};
+    for (; first!=last; ++first) {
+      size_type pos = *first;
+      if (pos / chunk_bits != key && !values.empty()) {
+        m_keys.push_back(key);
+        m_containers.push_back(make_container(values));
+        values.clear();
+      }
+      key = pos / chunk_bits;
+      if (values.empty() || values.back() != pos % chunk_bits) {
+        values.push_back(pos % chunk_bits);
+      }
+    }
+    if (!values.empty()) {
+      m_keys.push_back(key);
+      m_containers.push_back(make_container(values));
+    }
+  }
+
+  size_type size() const {
+    return m_num_bits;
+  }
+
+  size_type count() const {
+    size_type result = 0;
+    for (auto const & c : m_containers) {
+      result += c.cardinality;
+    }
+    return result;
+  }
+
+  bool test(size_type pos) const {
+    auto it = std::lower_bound(m_keys.cbegin(), m_keys.cend(), pos / chunk_bits);
+    if (it == m_keys.cend() || *it != pos / chunk_bits) {
+      return false;
+    }
+    auto const & c = m_containers[std::distance(m_keys.cbegin(), it)];
+    std::uint16_t v = pos % chunk_bits;
+    switch (c.kind) {
+      case container_kind::array:
+        return std::binary_search(c.values.cbegin(), c.values.cend(), v);
+      case container_kind::bitmap:
+        return (c.blocks[v / bits_per_block] >> (v % bits_per_block)) & 1;
+      case container_kind::run: {
+        for (size_type r=0; r<c.values.size() && c.values[r]<=v; r+=2) {
+          if (v <= c.values[r+1]) {
+            return true;
+          }
+        }
+        return false;
+      }
+    }
+    return false;
+  }
+};
+
+// Calls op(block, mask) for every non-empty block of dst, where mask is the
+// corresponding block of row, and stores the result back in dst.
+template <typename Op>
+void combine_blocks(hierarchical_bitset & dst, compressed_bitset const & row, Op op) {
+  using size_type = compressed_bitset::size_type;
+  constexpr auto blocks_per_chunk = compressed_bitset::blocks_per_chunk;
+
+  size_type k = 0;
+  size_type cursor = 0;
+  for (auto b=dst.find_block(0); b!=hierarchical_bitset::npos; b=dst.find_block(b+1)) {
+    auto key = b / blocks_per_chunk;
+    if (k < row.m_keys.size() && row.m_keys[k] < key) {
+      k = std::distance(
+          row.m_keys.cbegin(),
+          std::lower_bound(std::next(row.m_keys.cbegin(), k), row.m_keys.cend(), key));
+      cursor = 0;
+    }
+    if (k < row.m_keys.size() && row.m_keys[k] == key) {
+      auto mask = compressed_bitset::block_mask(row.m_containers[k], b % blocks_per_chunk, cursor);
+      dst.set_block(b, op(dst.block(b), mask));
+    } else {
+      dst.set_block(b, op(dst.block(b), compressed_bitset::block_type{0}));
+    }
+  }
+}
+
+// dst &= row
+inline void and_assign(hierarchical_bitset & dst, compressed_bitset const & row) {
+  combine_blocks(dst, row, [](auto block, auto mask) {
+    return block & mask;
+  });
+}
+
+// dst &= ~row
+inline void and_not_assign(hierarchical_bitset & dst, compressed_bitset const & row) {
+  combine_blocks(dst, row, [](auto block, auto mask) {
+    return block & ~mask;
+  });
+}
+
+}  // namespace sics
+
+#endif  // SICS_COMPRESSED_BITSET_H_
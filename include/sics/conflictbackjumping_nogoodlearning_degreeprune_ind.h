@@ -0,0 +1,202 @@
+#ifndef SICS_CONFLICTBACKJUMPING_NOGOODLEARNING_DEGREEPRUNE_IND_H_
+#define SICS_CONFLICTBACKJUMPING_NOGOODLEARNING_DEGREEPRUNE_IND_H_
+
+#include <cstddef>
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "nogood_store.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// conflictbackjumping_degreeprune_ind that keeps what it learns.  When all
+// values of the vertex at some level fail and no solution was found below
+// it, the assignments of the levels in its conflict set form a nogood, which
+// is added to a nogood_store of at most nogood_capacity entries.  Candidates
+// completing a stored nogood are rejected, with the levels of the nogood's
+// other literals as the conflict.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void conflictbackjumping_nogoodlearning_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv(),
+    std::size_t nogood_capacity = 100000) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+
+    IndexG backjump_level;
+    std::vector<boost::dynamic_bitset<>> conflicts;
+
+    std::vector<IndexG> level_of;
+    std::size_t solutions;
+    nogood_store<IndexG, IndexH> nogoods;
+    std::vector<std::pair<IndexG, IndexH>> nogood;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv,
+        std::size_t nogood_capacity)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          level{0},
+          map(m, n),
+          backjump_level{m},
+          conflicts(m, boost::dynamic_bitset<>(m)),
+          level_of(m),
+          solutions{0},
+          nogoods(m, n, nogood_capacity) {
+      for (IndexG i=0; i<m; ++i) {
+        level_of[index_order_g[i]] = i;
+      }
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        ++solutions;
+        backjump_level = m;
+        conflicts[m-1].set();
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+        conflicts[level].reset();
+        backjump_level = level+1;
+        auto solutions_before = solutions;
+        bool proceed = true;
+        for (IndexH y=0; y<n; ++y) {
+          if (consistency(y)) {
+            map[x] = y;
+            ++level;
+            proceed = explore();
+            --level;
+            map[x] = n;
+            if (!proceed || backjump_level <= level) {
+              return proceed;
+            }
+          }
+        }
+        auto pos = conflicts[level].find_next(m-1-level);
+        if (pos != boost::dynamic_bitset<>::npos) {
+          backjump_level = m - pos;
+        } else {
+          backjump_level = 0;
+        }
+
+        if (solutions == solutions_before) {
+          record_nogood();
+        }
+
+        if (backjump_level > 0) {
+          conflicts[backjump_level-1] |= conflicts[level];
+        }
+        return proceed;
+      }
+    }
+
+    void record_nogood() {
+      nogood.clear();
+      for (auto pos=conflicts[level].find_next(m-1-level); pos!=boost::dynamic_bitset<>::npos; pos=conflicts[level].find_next(pos)) {
+        auto u = index_order_g[m-1-pos];
+        nogood.emplace_back(u, map[u]);
+      }
+      if (!nogood.empty()) {
+        nogoods.add(nogood.cbegin(), nogood.cend());
+      }
+    }
+
+    bool consistency(IndexH y) {
+      auto x = index_order_g[level];
+
+      if (!vertex_equiv(g, x, h, y) ||
+          !degree_condition(g, x, h, y)) {
+        return false;
+      }
+
+      for (IndexG i=0; i<level; ++i) {
+        auto u = index_order_g[i];
+        auto v = map[u];
+        if (v == y) {
+          conflicts[level].set(m-1-i);
+          return false;
+        }
+        auto x_out = g.edge(x, u);
+        if (x_out != h.edge(y, v) || (x_out && !edge_equiv(g, x, u, h, y, v))) {
+          conflicts[level].set(m-1-i);
+          return false;
+        }
+        if constexpr (is_directed_v<G>) {
+          auto x_in = g.edge(u, x);
+          if (x_in != h.edge(v, y) || (x_in && !edge_equiv(g, u, x, h, v, y))) {
+            conflicts[level].set(m-1-i);
+            return false;
+          }
+        }
+      }
+
+      auto id = nogoods.find_violated(x, y, map);
+      if (id != decltype(nogoods)::npos) {
+        for (auto [u, v] : nogoods.literals(id)) {
+          if (u != x) {
+            conflicts[level].set(m-1-level_of[u]);
+          }
+        }
+        return false;
+      }
+      return true;
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv, nogood_capacity);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_CONFLICTBACKJUMPING_NOGOODLEARNING_DEGREEPRUNE_IND_H_
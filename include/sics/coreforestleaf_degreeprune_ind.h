@@ -0,0 +1,523 @@
+#ifndef SICS_COREFORESTLEAF_DEGREEPRUNE_IND_H_
+#define SICS_COREFORESTLEAF_DEGREEPRUNE_IND_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "parent_candidates.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// Core-forest-leaf decomposition, in the style of CFL-Match.
+//
+// g is split into its 2-core, its leaves (vertices with a single neighbour,
+// which is not itself a leaf) and the forest in between.  The core is
+// matched first, then the forest, each vertex after a neighbour so that its
+// candidates come from parent_candidates; index_order_g only decides the
+// order within those constraints.  The leaves are left until the rest is
+// mapped.  A leaf only has to be adjacent to the image of its parent,
+// non-adjacent to every other image and, for an induced embedding,
+// non-adjacent to the images of the other leaves.  So the leaves with the
+// same candidate set are interchangeable.  Only the sets of images are
+// chosen, and each choice stands for k! embeddings per group of k leaves.
+// When the candidate sets are disjoint and no two candidates are adjacent,
+// the leaves are counted without any search.
+//
+// coreforestleaf_degreeprune_ind calls callback once per embedding.
+// coreforestleaf_degreeprune_count_ind returns the number of embeddings and
+// is where the combinatorial counting pays off.
+namespace coreforestleaf_impl {
+
+// Calls emit(k) for every k embeddings found; stops when it returns false.
+template <
+    typename G,
+    typename H,
+    typename Emit,
+    typename IndexOrderG,
+    typename VertexEquiv,
+    typename EdgeEquiv>
+void explore(
+    G const & g,
+    H const & h,
+    Emit const & emit,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv,
+    EdgeEquiv const & edge_equiv) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Emit const & emit;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    // core and forest vertices first, then the leaves from num_matched on
+    std::vector<IndexG> order;
+    IndexG num_matched;
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+    std::vector<IndexG> inv;
+
+    // sorted neighbours of u in either direction
+    std::vector<std::vector<IndexG>> neighbours;
+    void build_neighbours() {
+      for (IndexG u=0; u<m; ++u) {
+        for (auto oe : edges_or_out_edges(g, u)) {
+          if (oe.target != u) {
+            neighbours[u].push_back(oe.target);
+          }
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto ie : g.in_edges(u)) {
+            if (ie.target != u) {
+              neighbours[u].push_back(ie.target);
+            }
+          }
+        }
+        std::sort(neighbours[u].begin(), neighbours[u].end());
+        neighbours[u].erase(std::unique(neighbours[u].begin(), neighbours[u].end()), neighbours[u].end());
+      }
+    }
+
+    enum : char {
+      core,
+      forest,
+      leaf
+    };
+    void build_order(IndexOrderG const & index_order_g) {
+      std::vector<IndexG> position(m);
+      for (IndexG i=0; i<m; ++i) {
+        position[index_order_g[i]] = i;
+      }
+
+      // the 2-core is what is left after repeatedly removing the vertices
+      // with at most one neighbour
+      std::vector<char> kind(m, core);
+      std::vector<IndexG> remaining(m);
+      std::vector<IndexG> removed;
+      for (IndexG u=0; u<m; ++u) {
+        remaining[u] = neighbours[u].size();
+        if (remaining[u] <= 1) {
+          kind[u] = forest;
+          removed.push_back(u);
+        }
+      }
+      while (!removed.empty()) {
+        auto u = removed.back();
+        removed.pop_back();
+        for (auto w : neighbours[u]) {
+          if (kind[w] == core && --remaining[w] <= 1) {
+            kind[w] = forest;
+            removed.push_back(w);
+          }
+        }
+      }
+      for (IndexG u=0; u<m; ++u) {
+        if (kind[u] == forest && neighbours[u].size() == 1) {
+          auto p = neighbours[u].front();
+          if (neighbours[p].size() > 1 || position[p] < position[u]) {
+            kind[u] = leaf;
+          }
+        }
+      }
+
+      // within core, then forest, the first vertex of index_order_g with an
+      // already placed neighbour, or the first one if there is none
+      std::vector<bool> placed(m, false);
+      std::vector<IndexG> placed_neighbours(m, 0);
+      for (char k : {core, forest}) {
+        while (true) {
+          IndexG next = m;
+          for (auto u : index_order_g) {
+            if (!placed[u] && kind[u] == k) {
+              if (placed_neighbours[u] > 0) {
+                next = u;
+                break;
+              } else if (next == m) {
+                next = u;
+              }
+            }
+          }
+          if (next == m) {
+            break;
+          }
+          placed[next] = true;
+          order.push_back(next);
+          for (auto w : neighbours[next]) {
+            ++placed_neighbours[w];
+          }
+        }
+      }
+      num_matched = order.size();
+      for (auto u : index_order_g) {
+        if (kind[u] == leaf) {
+          order.push_back(u);
+        }
+      }
+    }
+
+    using parent_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<IndexG, bool>,
+        std::tuple<IndexG>>;
+    std::vector<parent_type> parents;
+    void build_parents() {
+      for (IndexG u=0; u<m; ++u) {
+        std::get<0>(parents[u]) = m;
+      }
+      std::vector<bool> done(m, false);
+      for (auto u : order) {
+        done[u] = true;
+        if constexpr (is_directed_v<G>) {
+          for (auto oe : g.out_edges(u)) {
+            auto i = oe.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u, true};
+            }
+          }
+          for (auto ie : g.in_edges(u)) {
+            auto i = ie.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u, false};
+            }
+          }
+        } else {
+          for (auto e : g.edges(u)) {
+            auto i = e.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u};
+            }
+          }
+        }
+      }
+    }
+
+    parent_candidates<G, H, VertexEquiv> candidates;
+
+    // leaf_candidates[j]: sorted candidates of the leaf order[num_matched+j]
+    std::vector<std::vector<IndexH>> leaf_candidates;
+    std::vector<IndexG> leaf_ids;
+    // groups of leaves with the same candidates, and the leaf images chosen
+    std::vector<std::tuple<std::vector<IndexH> const *, IndexG>> groups;
+    std::vector<IndexH> chosen;
+    std::vector<char> leaf_mark;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Emit const & emit,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          emit{emit},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          num_matched{0},
+          level{0},
+          map(m, n),
+          inv(n, m),
+          neighbours(m),
+          parents(m),
+          candidates(g, h),
+          leaf_mark(n, false) {
+      build_neighbours();
+      build_order(index_order_g);
+      build_parents();
+      leaf_candidates.resize(m - num_matched);
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == num_matched) {
+        return explore_leaves();
+      } else {
+        auto x = order[level];
+        bool proceed = true;
+
+        parent_type p = parents[x];
+        if (std::get<0>(p) == m) {
+          for (IndexH y=0; y<n; ++y) {
+            if (consistency(x, y)) {
+              proceed = assign_and_explore(x, y);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        } else {
+          for (auto he : get_parent_edges(x, p)) {
+            auto y = he.target;
+            if (consistency(x, y)) {
+              proceed = assign_and_explore(x, y);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        }
+
+        return proceed;
+      }
+    }
+
+    bool assign_and_explore(IndexG x, IndexH y) {
+      map[x] = y;
+      inv[y] = x;
+      ++level;
+      bool proceed = explore();
+      --level;
+      inv[y] = m;
+      map[x] = n;
+      return proceed;
+    }
+
+    auto get_parent_edges(IndexG x, parent_type p) {
+      if constexpr (is_directed_v<H>) {
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
+      } else {
+        return candidates.edges(x, map[std::get<0>(p)]);
+      }
+    }
+
+    // y is a candidate for x given the images of the first level vertices
+    bool consistency(IndexG x, IndexH y) {
+      if (inv[y] != m ||
+          !vertex_equiv(g, x, h, y) ||
+          !degree_condition(g, x, h, y)) {
+        return false;
+      }
+      for (IndexG i=0; i<level; ++i) {
+        auto u = order[i];
+        auto v = map[u];
+        auto x_out = g.edge(x, u);
+        if (x_out != h.edge(y, v) || (x_out && !edge_equiv(g, x, u, h, y, v))) {
+          return false;
+        }
+        if constexpr (is_directed_v<G>) {
+          auto x_in = g.edge(u, x);
+          if (x_in != h.edge(v, y) || (x_in && !edge_equiv(g, u, x, h, v, y))) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    bool explore_leaves() {
+      if (num_matched == m) {
+        return emit(1);
+      }
+
+      for (IndexG j=0; j<m-num_matched; ++j) {
+        auto x = order[num_matched + j];
+        auto & C = leaf_candidates[j];
+        C.clear();
+        for (auto he : get_parent_edges(x, parents[x])) {
+          if (consistency(x, he.target)) {
+            C.push_back(he.target);
+          }
+        }
+        if (C.empty()) {
+          return true;
+        }
+        std::sort(C.begin(), C.end());
+      }
+
+      leaf_ids.resize(m - num_matched);
+      for (IndexG j=0; j<m-num_matched; ++j) {
+        leaf_ids[j] = j;
+      }
+      std::sort(leaf_ids.begin(), leaf_ids.end(), [this](auto a, auto b) {
+        return leaf_candidates[a] < leaf_candidates[b];
+      });
+      groups.clear();
+      std::uintmax_t permutations = 1;
+      for (auto j : leaf_ids) {
+        auto const * C = &leaf_candidates[j];
+        if (!groups.empty() && *std::get<0>(groups.back()) == *C) {
+          permutations *= ++std::get<1>(groups.back());
+        } else {
+          groups.emplace_back(C, 1);
+        }
+        if (std::get<1>(groups.back()) > C->size()) {
+          return true;
+        }
+      }
+
+      if (independent_disjoint_candidates()) {
+        std::uintmax_t count = 1;
+        for (auto [C, k] : groups) {
+          for (IndexG i=0; i<k; ++i) {
+            count *= C->size() - i;
+          }
+        }
+        return emit(count);
+      }
+      return choose(0, 0, std::get<1>(groups.front()), permutations);
+    }
+
+    // whether the candidate sets of the groups are pairwise disjoint and no
+    // two candidates are adjacent
+    bool independent_disjoint_candidates() {
+      bool result = true;
+      for (auto [C, k] : groups) {
+        for (auto y : *C) {
+          result = result && !leaf_mark[y];
+          leaf_mark[y] = true;
+        }
+      }
+      for (auto it=groups.cbegin(); it!=groups.cend() && result; ++it) {
+        for (auto y : *std::get<0>(*it)) {
+          for (auto oe : edges_or_out_edges(h, y)) {
+            if (leaf_mark[oe.target]) {
+              result = false;
+              break;
+            }
+          }
+          if (!result) {
+            break;
+          }
+        }
+      }
+      for (auto [C, k] : groups) {
+        for (auto y : *C) {
+          leaf_mark[y] = false;
+        }
+      }
+      return result;
+    }
+
+    bool leaf_fits(IndexH y) {
+      if (leaf_mark[y]) {
+        return false;
+      }
+      for (auto z : chosen) {
+        if (h.edge(y, z)) {
+          return false;
+        }
+        if constexpr (is_directed_v<H>) {
+          if (h.edge(z, y)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    // chooses left more images for group gi from its candidates from index
+    // from on, in increasing order
+    bool choose(std::size_t gi, std::size_t from, IndexG left, std::uintmax_t permutations) {
+      if (left == 0) {
+        if (gi + 1 == groups.size()) {
+          return emit(permutations);
+        }
+        return choose(gi + 1, 0, std::get<1>(groups[gi + 1]), permutations);
+      }
+      auto const & C = *std::get<0>(groups[gi]);
+      if (left == 1 && gi + 1 == groups.size()) {
+        std::uintmax_t count = 0;
+        for (auto i=from; i<C.size(); ++i) {
+          if (leaf_fits(C[i])) {
+            ++count;
+          }
+        }
+        return count == 0 || emit(count * permutations);
+      }
+      for (auto i=from; i+left<=C.size(); ++i) {
+        auto y = C[i];
+        if (leaf_fits(y)) {
+          leaf_mark[y] = true;
+          chosen.push_back(y);
+          bool proceed = choose(gi, i + 1, left - 1, permutations);
+          chosen.pop_back();
+          leaf_mark[y] = false;
+          if (!proceed) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  } e(g, h, emit, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace coreforestleaf_impl
+
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void coreforestleaf_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  auto emit = [&callback](std::uintmax_t k) {
+    for (std::uintmax_t i=0; i<k; ++i) {
+      if (!callback()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  coreforestleaf_impl::explore(g, h, emit, index_order_g, vertex_equiv, edge_equiv);
+}
+
+template <
+    typename G,
+    typename H,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+std::uintmax_t coreforestleaf_degreeprune_count_ind(
+    G const & g,
+    H const & h,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  std::uintmax_t count = 0;
+  auto emit = [&count](std::uintmax_t k) {
+    count += k;
+    return true;
+  };
+  coreforestleaf_impl::explore(g, h, emit, index_order_g, vertex_equiv, edge_equiv);
+  return count;
+}
+
+}  // namespace sics
+
+#endif  // SICS_COREFORESTLEAF_DEGREEPRUNE_IND_H_
@@ -0,0 +1,263 @@
+#ifndef SICS_FAILINGSETS_CANDIDATESPACE_MRV_DEGREEPRUNE_IND_H_
+#define SICS_FAILINGSETS_CANDIDATESPACE_MRV_DEGREEPRUNE_IND_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+#include "candidate_space.h"
+#include "sorted_intersection.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// Failing-set pruning over a DAG of g, in the style of DAF.
+//
+// The DAG orients every edge of g along the breadth-first order of a
+// candidate_space, so the parents of u are its backward neighbours.  A
+// vertex is extendable once all its parents are mapped; its candidates are
+// then the intersection of the lists of the index for their images, and do
+// not change until one of them is unmapped.  The next vertex is always the
+// extendable one with the fewest candidates.
+//
+// Every subtree that fails returns a failing set F, a union of ancestor
+// sets anc(u) (u and its ancestors in the DAG): no embedding extends the
+// mapping restricted to F.  A vertex with no candidates fails with anc(x);
+// a candidate taken by u, or adjacent to the image of a non-neighbour u,
+// fails with anc(x) | anc(u).  If the subtree for x -> y fails with an F
+// that does not contain x, the other candidates of x agree with the current
+// mapping on F and fail as well, so they are skipped and F is returned.
+// Otherwise the node fails with the union of the sets of its children.  A
+// subtree that found an embedding returns the empty set, which never prunes.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void failingsets_candidatespace_mrv_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    candidate_space<G, H, VertexEquiv, EdgeEquiv> space;
+
+    IndexG m;
+    IndexH n;
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+    std::vector<IndexG> inv;
+    // map_index[u]: the position of map[u] in space.candidates(u)
+    std::vector<IndexH> map_index;
+    // the mapped vertices, in the order they were mapped
+    std::vector<IndexG> mapped;
+
+    // children[u]: the vertices with u as a parent in the DAG, and anc[u]
+    std::vector<std::vector<IndexG>> children;
+    std::vector<boost::dynamic_bitset<>> anc;
+    void build_dag() {
+      for (auto u : space.order()) {
+        anc[u].set(u);
+        for (auto w : space.backward_neighbours(u)) {
+          children[w].push_back(u);
+          anc[u] |= anc[w];
+        }
+      }
+    }
+
+    // unmapped_parents[u], and for extendable u, its candidates as positions
+    // in space.candidates(u)
+    std::vector<IndexG> unmapped_parents;
+    std::vector<std::vector<IndexH>> candidates;
+    std::vector<IndexG> extendable;
+    std::vector<IndexH> scratch;
+    std::vector<std::pair<IndexH const *, std::size_t>> lists;
+
+    // failing[l]: the failing set returned by the node at level l, empty if
+    // an embedding was found below it
+    std::vector<boost::dynamic_bitset<>> failing;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          space(g, h, vertex_equiv, edge_equiv),
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          level{0},
+          map(m, n),
+          inv(n, m),
+          map_index(m, n),
+          children(m),
+          anc(m, boost::dynamic_bitset<>(m)),
+          unmapped_parents(m),
+          candidates(m),
+          failing(m + 1, boost::dynamic_bitset<>(m)) {
+      build_dag();
+      for (auto u : space.order()) {
+        unmapped_parents[u] = space.backward_neighbours(u).size();
+        if (unmapped_parents[u] == 0) {
+          candidates[u].resize(space.candidates(u).size());
+          for (IndexH j=0; j<candidates[u].size(); ++j) {
+            candidates[u][j] = j;
+          }
+          extendable.push_back(u);
+        }
+      }
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      auto & F = failing[level];
+      F.reset();
+      if (level == m) {
+        return callback();
+      }
+
+      auto it = std::min_element(extendable.begin(), extendable.end(), [this](auto a, auto b) {
+        return candidates[a].size() < candidates[b].size();
+      });
+      auto position = std::distance(extendable.begin(), it);
+      auto x = *it;
+      extendable.erase(it);
+
+      auto const & C = space.candidates(x);
+      bool found = false;
+      bool proceed = true;
+      for (auto j : candidates[x]) {
+        auto y = C[j];
+        auto u = conflict(x, y);
+        if (u != m) {
+          F |= anc[x];
+          F |= anc[u];
+          continue;
+        }
+
+        assign(x, j);
+        ++level;
+        proceed = explore();
+        --level;
+        unassign(x);
+        if (!proceed) {
+          break;
+        }
+
+        auto const & child = failing[level + 1];
+        if (child.none()) {
+          found = true;
+        } else if (!child.test(x)) {
+          F = child;
+          break;
+        } else {
+          F |= child;
+        }
+      }
+      if (found) {
+        F.reset();
+      } else if (F.none()) {
+        F = anc[x];
+      }
+
+      extendable.insert(std::next(extendable.begin(), position), x);
+      return proceed;
+    }
+
+    // m if x can be mapped to y, otherwise the mapped vertex it conflicts
+    // with: the one mapped to y, or a non-neighbour of x whose image is
+    // adjacent to y
+    IndexG conflict(IndexG x, IndexH y) {
+      if (inv[y] != m) {
+        return inv[y];
+      }
+      for (auto u : mapped) {
+        if (!g.edge(x, u) && !g.edge(u, x)) {
+          auto v = map[u];
+          if (h.edge(y, v) || h.edge(v, y)) {
+            return u;
+          }
+        }
+      }
+      return m;
+    }
+
+    void assign(IndexG x, IndexH j) {
+      auto y = space.candidates(x)[j];
+      map[x] = y;
+      map_index[x] = j;
+      inv[y] = x;
+      mapped.push_back(x);
+      for (auto c : children[x]) {
+        if (--unmapped_parents[c] == 0) {
+          build_candidates(c);
+          extendable.push_back(c);
+        }
+      }
+    }
+
+    void unassign(IndexG x) {
+      for (auto it=children[x].crbegin(); it!=children[x].crend(); ++it) {
+        if (unmapped_parents[*it]++ == 0) {
+          extendable.pop_back();
+        }
+      }
+      mapped.pop_back();
+      inv[map[x]] = m;
+      map_index[x] = n;
+      map[x] = n;
+    }
+
+    void build_candidates(IndexG x) {
+      auto const & backward = space.backward_neighbours(x);
+
+      lists.clear();
+      for (std::size_t k=0; k<backward.size(); ++k) {
+        auto r = space.adjacent(x, k, map_index[backward[k]]);
+        lists.emplace_back(r.begin(), r.size());
+      }
+      std::sort(lists.begin(), lists.end(), [](auto a, auto b) {
+        return a.second < b.second;
+      });
+
+      auto & result = candidates[x];
+      result.assign(lists.front().first, lists.front().first + lists.front().second);
+      for (auto it=std::next(lists.cbegin()); it!=lists.cend() && !result.empty(); ++it) {
+        scratch.resize(result.size() + sorted_intersection_padding);
+        scratch.resize(sorted_intersection(result.data(), result.size(), it->first, it->second, scratch.data()));
+        std::swap(result, scratch);
+      }
+    }
+  } e(g, h, callback, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_FAILINGSETS_CANDIDATESPACE_MRV_DEGREEPRUNE_IND_H_
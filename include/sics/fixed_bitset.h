@@ -0,0 +1,238 @@
+#ifndef SICS_FIXED_BITSET_H_
+#define SICS_FIXED_BITSET_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+
+#include "block_bitset.h"
+
+namespace sics {
+
+// A bitset of at most 64*K bits stored inline.  It has the same interface as
+// block_bitset, but all loops run over the compile-time number of blocks K,
+// so for small targets they are fully unrolled and the bitset needs no heap
+// storage.  Bits past size() are always zero.
+template <std::size_t K>
+class fixed_bitset {
+ public:
+  using block_type = std::uint64_t;
+  using size_type = std::size_t;
+
+  static constexpr size_type bits_per_block = 64;
+  static constexpr size_type max_size = K * bits_per_block;
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+ private:
+  size_type m_num_bits;
+  std::array<block_type, K> m_blocks;
+
+  static size_type block_index(size_type pos) {
+    return pos / bits_per_block;
+  }
+
+  static size_type bit_index(size_type pos) {
+    return pos % bits_per_block;
+  }
+
+  size_type find_from_block(size_type b) const {
+    for (; b<K; ++b) {
+      if (m_blocks[b]) {
+        return b * bits_per_block + __builtin_ctzll(m_blocks[b]);
+      }
+    }
+    return npos;
+  }
+
+ public:
+  fixed_bitset()
+      : m_num_bits{0},
+        m_blocks{} {
+  }
+
+  explicit fixed_bitset(size_type num_bits)
+      : m_num_bits{num_bits},
+        m_blocks{} {
+  }
+
+  void resize(size_type num_bits) {
+    for (auto b=block_index(num_bits); b<K; ++b) {
+      if (b == block_index(num_bits)) {
+        m_blocks[b] &= ~(~block_type{0} << bit_index(num_bits));
+      } else {
+        m_blocks[b] = 0;
+      }
+    }
+    m_num_bits = num_bits;
+  }
+
+  size_type size() const {
+    return m_num_bits;
+  }
+
+  static constexpr size_type num_blocks() {
+    return K;
+  }
+
+  bool test(size_type pos) const {
+    return (m_blocks[block_index(pos)] >> bit_index(pos)) & 1;
+  }
+
+  bool operator[](size_type pos) const {
+    return test(pos);
+  }
+
+  fixed_bitset & set(size_type pos) {
+    m_blocks[block_index(pos)] |= block_type{1} << bit_index(pos);
+    return *this;
+  }
+
+  fixed_bitset & set() {
+    m_blocks.fill(~block_type{0});
+    resize(m_num_bits);
+    return *this;
+  }
+
+  fixed_bitset & reset(size_type pos) {
+    m_blocks[block_index(pos)] &= ~(block_type{1} << bit_index(pos));
+    return *this;
+  }
+
+  fixed_bitset & reset() {
+    m_blocks.fill(0);
+    return *this;
+  }
+
+  bool any() const {
+    block_type acc = 0;
+    for (size_type b=0; b<K; ++b) {
+      acc |= m_blocks[b];
+    }
+    return acc != 0;
+  }
+
+  bool none() const {
+    return !any();
+  }
+
+  size_type count() const {
+    size_type result = 0;
+    for (size_type b=0; b<K; ++b) {
+      result += __builtin_popcountll(m_blocks[b]);
+    }
+    return result;
+  }
+
+  size_type find_first() const {
+    return find_from_block(0);
+  }
+
+  size_type find_next(size_type pos) const {
+    ++pos;
+    if (pos >= max_size) {
+      return npos;
+    }
+    auto b = block_index(pos);
+    auto rest = m_blocks[b] & (~block_type{0} << bit_index(pos));
+    if (rest) {
+      return b * bits_per_block + __builtin_ctzll(rest);
+    }
+    return find_from_block(b + 1);
+  }
+
+  fixed_bitset & operator&=(fixed_bitset const & other) {
+    for (size_type b=0; b<K; ++b) {
+      m_blocks[b] &= other.m_blocks[b];
+    }
+    return *this;
+  }
+
+  fixed_bitset & operator|=(fixed_bitset const & other) {
+    for (size_type b=0; b<K; ++b) {
+      m_blocks[b] |= other.m_blocks[b];
+    }
+    return *this;
+  }
+
+  // Set difference, *this & ~other.
+  fixed_bitset & operator-=(fixed_bitset const & other) {
+    for (size_type b=0; b<K; ++b) {
+      m_blocks[b] &= ~other.m_blocks[b];
+    }
+    return *this;
+  }
+
+  // *this &= other; return any()
+  bool and_any(fixed_bitset const & other) {
+    *this &= other;
+    return any();
+  }
+
+  // *this &= ~other; return any()
+  bool and_not_any(fixed_bitset const & other) {
+    *this -= other;
+    return any();
+  }
+
+  // *this &= other; return count()
+  size_type and_count(fixed_bitset const & other) {
+    *this &= other;
+    return count();
+  }
+
+  // *this &= ~other; return count()
+  size_type and_not_count(fixed_bitset const & other) {
+    *this -= other;
+    return count();
+  }
+
+  // *this |= other; return count()
+  size_type or_count(fixed_bitset const & other) {
+    *this |= other;
+    return count();
+  }
+
+  // (*this & mask) == expected
+  bool and_equals(fixed_bitset const & mask, fixed_bitset const & expected) const {
+    block_type diff = 0;
+    for (size_type b=0; b<K; ++b) {
+      diff |= (m_blocks[b] & mask.m_blocks[b]) ^ expected.m_blocks[b];
+    }
+    return diff == 0;
+  }
+
+  friend bool operator==(fixed_bitset const & a, fixed_bitset const & b) {
+    return a.m_num_bits == b.m_num_bits && a.m_blocks == b.m_blocks;
+  }
+
+  friend bool operator!=(fixed_bitset const & a, fixed_bitset const & b) {
+    return !(a == b);
+  }
+};
+
+template <typename Bitset>
+struct bitset_tag {
+  using type = Bitset;
+};
+
+// Calls f(bitset_tag<B>{}) with the narrowest fixed_bitset B that holds
+// num_bits bits, or with block_bitset if num_bits is larger than 512.
+template <typename F>
+void dispatch_bitset(std::size_t num_bits, F f) {
+  if (num_bits <= fixed_bitset<1>::max_size) {
+    f(bitset_tag<fixed_bitset<1>>{});
+  } else if (num_bits <= fixed_bitset<2>::max_size) {
+    f(bitset_tag<fixed_bitset<2>>{});
+  } else if (num_bits <= fixed_bitset<4>::max_size) {
+    f(bitset_tag<fixed_bitset<4>>{});
+  } else if (num_bits <= fixed_bitset<8>::max_size) {
+    f(bitset_tag<fixed_bitset<8>>{});
+  } else {
+    f(bitset_tag<block_bitset>{});
+  }
+}
+
+}  // namespace sics
+
+#endif  // SICS_FIXED_BITSET_H_
@@ -7,6 +7,8 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include "bitset_operations.h"
+
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
@@ -22,7 +24,8 @@ template <
     typename Callback,
     typename IndexOrderG,
     typename VertexEquiv = default_vertex_label_equiv<G, H>,
-    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename Bitset = boost::dynamic_bitset<>>
 void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
     G const & g,
     H const & h,
@@ -50,8 +53,8 @@ void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
 
     using bits_type = std::conditional_t<
         is_directed_v<H>,
-        std::tuple<boost::dynamic_bitset<>, boost::dynamic_bitset<>>,
-        std::tuple<boost::dynamic_bitset<>>>;
+        std::tuple<Bitset, Bitset>,
+        std::tuple<Bitset>>;
 
     std::vector<bits_type> h_bits;
     std::vector<bits_type> h_c_bits;
@@ -88,7 +91,7 @@ void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
 
     std::vector<IndexH> map;
 
-    std::vector<boost::dynamic_bitset<>> M;
+    std::vector<Bitset> M;
     void build_M() {
       for (IndexG u=0; u<m; ++u) {
         for (IndexH v=0; v<n; ++v) {
@@ -99,10 +102,10 @@ void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
         }
       }
     }
-    multi_stack<std::tuple<IndexG, boost::dynamic_bitset<>>> M_mst;
+    multi_stack<std::tuple<IndexG, Bitset>> M_mst;
 
-    boost::dynamic_bitset<> hall_set;
-    boost::dynamic_bitset<> work_set;
+    Bitset hall_set;
+    Bitset work_set;
 
     explorer(
         G const & g,
@@ -125,7 +128,7 @@ void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
           level{0},
           temp_index_order_g(m),
           map(m, n),
-          M(m, boost::dynamic_bitset<>(n)),
+          M(m, Bitset(n)),
           M_mst(m*n, m),
           hall_set(n),
           work_set(n){
@@ -141,7 +144,7 @@ void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
         auto x = index_order_g[level];
         std::copy(std::next(index_order_g.begin(), level), index_order_g.end(), std::next(temp_index_order_g.begin(), level));
         bool proceed = true;
-        for (auto y=M[x].find_first(); y!=boost::dynamic_bitset<>::npos; y=M[x].find_next(y)) {
+        for (auto y=M[x].find_first(); y!=Bitset::npos; y=M[x].find_next(y)) {
           M_mst.push_level();
           if (forward_check(y) &&
               (std::sort(std::next(temp_index_order_g.begin(), level+1), temp_index_order_g.end(), [this](auto a, auto b) {
@@ -173,21 +176,24 @@ void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
         M_mst.push({u, M[u]});
 
         M[u].reset(y);
-        if (g.edge(x, u)) {
-          M[u] &= std::get<0>(h_bits[y]);
-        } else {
-          M[u] &= std::get<0>(h_c_bits[y]);
-        }
-
         if constexpr (is_directed_v<G>) {
+          if (g.edge(x, u)) {
+            M[u] &= std::get<0>(h_bits[y]);
+          } else {
+            M[u] &= std::get<0>(h_c_bits[y]);
+          }
           if (g.edge(u, x)) {
-            M[u] &= std::get<1>(h_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_bits[y]));
           } else {
-            M[u] &= std::get<1>(h_c_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_c_bits[y]));
+          }
+        } else {
+          if (g.edge(x, u)) {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_c_bits[y]));
           }
         }
-
-        not_empty = M[u].any();
       }
       return not_empty;
     }
@@ -198,13 +204,11 @@ void forwardchecking_bitset_degreeprune_countingalldifferent_ind(
       IndexG count = 0;
       for (IndexG i=level+1; i<m; ++i) {
         auto u = temp_index_order_g[i];
-        M[u] &= ~hall_set;
-        if (!M[u].any()) {
+        if (!bitset_and_not_any(M[u], hall_set)) {
           return false;
         }
         ++count;
-        work_set |= M[u];
-        auto work_set_count = work_set.count();
+        auto work_set_count = bitset_or_count(work_set, M[u]);
         if (work_set_count < count) {
           return false;
         } else if (work_set_count == count) {
@@ -9,6 +9,8 @@
 #include <boost/dynamic_bitset.hpp>
 
 #include "adjacency_degreesortedlistmat.h"
+#include "bitset_operations.h"
+
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
@@ -23,7 +25,8 @@ template <
     typename Callback,
     typename IndexOrderG,
     typename VertexEquiv = default_vertex_label_equiv<G, H>,
-    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename Bitset = boost::dynamic_bitset<>>
 void forwardchecking_bitset_degreesequenceprune_ac1_ind(
     G const & g,
     H const & h,
@@ -60,8 +63,8 @@ void forwardchecking_bitset_degreesequenceprune_ac1_ind(
 
     using bits_type = std::conditional_t<
         is_directed_v<H>,
-        std::tuple<boost::dynamic_bitset<>, boost::dynamic_bitset<>>,
-        std::tuple<boost::dynamic_bitset<>>>;
+        std::tuple<Bitset, Bitset>,
+        std::tuple<Bitset>>;
 
     std::vector<bits_type> h_bits;
     std::vector<bits_type> h_c_bits;
@@ -96,7 +99,7 @@ void forwardchecking_bitset_degreesequenceprune_ac1_ind(
 
     std::vector<IndexH> map;
 
-    std::vector<boost::dynamic_bitset<>> M;
+    std::vector<Bitset> M;
     void build_M() {
       for (IndexG u=0; u<m; ++u) {
         for (IndexH v=0; v<n; ++v) {
@@ -109,7 +112,7 @@ void forwardchecking_bitset_degreesequenceprune_ac1_ind(
       }
       ac1();
     }
-    std::stack<std::vector<boost::dynamic_bitset<>>> M_st;
+    std::stack<std::vector<Bitset>> M_st;
 
     explorer(
         G const & g,
@@ -131,7 +134,7 @@ void forwardchecking_bitset_degreesequenceprune_ac1_ind(
           h_c_bits(n),
           level{0},
           map(m, n),
-          M(m, boost::dynamic_bitset<>(n)) {
+          M(m, Bitset(n)) {
       build_h_bits();
       build_M();
     }
@@ -143,7 +146,7 @@ void forwardchecking_bitset_degreesequenceprune_ac1_ind(
       } else {
         auto x = index_order_g[level];
         bool proceed = true;
-        for (auto y=M[x].find_first(); y!=boost::dynamic_bitset<>::npos; y=M[x].find_next(y)) {
+        for (auto y=M[x].find_first(); y!=Bitset::npos; y=M[x].find_next(y)) {
           M_st.push(M);
           if (forward_check(y) && ac1()) {
             map[x] = y;
@@ -170,21 +173,24 @@ void forwardchecking_bitset_degreesequenceprune_ac1_ind(
         auto u = index_order_g[i];
 
         M[u].reset(y);
-        if (g.edge(x, u)) {
-          M[u] &= std::get<0>(h_bits[y]);
-        } else {
-          M[u] &= std::get<0>(h_c_bits[y]);
-        }
-
         if constexpr (is_directed_v<G>) {
+          if (g.edge(x, u)) {
+            M[u] &= std::get<0>(h_bits[y]);
+          } else {
+            M[u] &= std::get<0>(h_c_bits[y]);
+          }
           if (g.edge(u, x)) {
-            M[u] &= std::get<1>(h_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_bits[y]));
           } else {
-            M[u] &= std::get<1>(h_c_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_c_bits[y]));
+          }
+        } else {
+          if (g.edge(x, u)) {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_c_bits[y]));
           }
         }
-
-        not_empty = M[u].any();
       }
       return not_empty;
     }
@@ -195,11 +201,11 @@ void forwardchecking_bitset_degreesequenceprune_ac1_ind(
         change = false;
         for (IndexG i0=level+1; i0<m; ++i0) {
           auto u0 = index_order_g[i0];
-          for (auto v0=M[u0].find_first(); v0!=boost::dynamic_bitset<>::npos; v0=M[u0].find_next(v0)) {
+          for (auto v0=M[u0].find_first(); v0!=Bitset::npos; v0=M[u0].find_next(v0)) {
             for (IndexG u1=0; u1<m; ++u1) {
               if (u1 != u0) {
                 bool exists = false;
-                for (auto v1=M[u1].find_first(); v1!=boost::dynamic_bitset<>::npos; v1=M[u1].find_next(v1)) {
+                for (auto v1=M[u1].find_first(); v1!=Bitset::npos; v1=M[u1].find_next(v1)) {
                   if constexpr (is_directed_v<G>) {
                     if (v0 != v1 &&
                         (g.edge(u0, u1) == h.edge(v0, v1)) && (!g.edge(u0, u1) || edge_equiv(g, u0, u1, h, v0, v1)) &&
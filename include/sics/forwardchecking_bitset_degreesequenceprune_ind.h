@@ -8,6 +8,8 @@
 #include <boost/dynamic_bitset.hpp>
 
 #include "adjacency_degreesortedlistmat.h"
+#include "bitset_operations.h"
+
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
@@ -23,7 +25,8 @@ template <
     typename Callback,
     typename IndexOrderG,
     typename VertexEquiv = default_vertex_label_equiv<G, H>,
-    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename Bitset = boost::dynamic_bitset<>>
 void forwardchecking_bitset_degreesequenceprune_ind(
     G const & g,
     H const & h,
@@ -60,8 +63,8 @@ void forwardchecking_bitset_degreesequenceprune_ind(
 
     using bits_type = std::conditional_t<
         is_directed_v<H>,
-        std::tuple<boost::dynamic_bitset<>, boost::dynamic_bitset<>>,
-        std::tuple<boost::dynamic_bitset<>>>;
+        std::tuple<Bitset, Bitset>,
+        std::tuple<Bitset>>;
 
     std::vector<bits_type> h_bits;
     std::vector<bits_type> h_c_bits;
@@ -96,7 +99,7 @@ void forwardchecking_bitset_degreesequenceprune_ind(
 
     std::vector<IndexH> map;
 
-    std::vector<boost::dynamic_bitset<>> M;
+    std::vector<Bitset> M;
     void build_M() {
       for (IndexG u=0; u<m; ++u) {
         for (IndexH v=0; v<n; ++v) {
@@ -108,7 +111,7 @@ void forwardchecking_bitset_degreesequenceprune_ind(
         }
       }
     }
-    multi_stack<std::tuple<IndexG, boost::dynamic_bitset<>>> M_mst;
+    multi_stack<std::tuple<IndexG, Bitset>> M_mst;
 
     explorer(
         G const & g,
@@ -130,7 +133,7 @@ void forwardchecking_bitset_degreesequenceprune_ind(
           h_c_bits(n),
           level{0},
           map(m, n),
-          M(m, boost::dynamic_bitset<>(n)),
+          M(m, Bitset(n)),
           M_mst(m*n, m) {
       build_h_bits();
       build_M();
@@ -143,7 +146,7 @@ void forwardchecking_bitset_degreesequenceprune_ind(
       } else {
         auto x = index_order_g[level];
         bool proceed = true;
-        for (auto y=M[x].find_first(); y!=boost::dynamic_bitset<>::npos; y=M[x].find_next(y)) {
+        for (auto y=M[x].find_first(); y!=Bitset::npos; y=M[x].find_next(y)) {
           M_mst.push_level();
           if (forward_check(y)) {
             map[x] = y;
@@ -172,21 +175,24 @@ void forwardchecking_bitset_degreesequenceprune_ind(
         M_mst.push({u, M[u]});
 
         M[u].reset(y);
-        if (g.edge(x, u)) {
-          M[u] &= std::get<0>(h_bits[y]);
-        } else {
-          M[u] &= std::get<0>(h_c_bits[y]);
-        }
-
         if constexpr (is_directed_v<G>) {
+          if (g.edge(x, u)) {
+            M[u] &= std::get<0>(h_bits[y]);
+          } else {
+            M[u] &= std::get<0>(h_c_bits[y]);
+          }
           if (g.edge(u, x)) {
-            M[u] &= std::get<1>(h_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_bits[y]));
           } else {
-            M[u] &= std::get<1>(h_c_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_c_bits[y]));
+          }
+        } else {
+          if (g.edge(x, u)) {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_c_bits[y]));
           }
         }
-
-        not_empty = M[u].any();
       }
       return not_empty;
     }
@@ -0,0 +1,280 @@
+#ifndef SICS_FORWARDCHECKING_BITSET_DOMWDEG_DEGREEPRUNE_COUNTINGALLDIFFERENT_IND_H_
+#define SICS_FORWARDCHECKING_BITSET_DOMWDEG_DEGREEPRUNE_COUNTINGALLDIFFERENT_IND_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <numeric>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bitset_operations.h"
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "multi_stack.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// Like forwardchecking_bitset_mrv_degreeprune_countingalldifferent_ind, but
+// variables are chosen by dom/wdeg.  Every pair of pattern vertices is a
+// constraint (an edge or a non-edge) with a weight, initially 1, that is
+// incremented whenever it wipes out a domain in forward_check() or takes
+// part in a failed counting_all_different().  The next vertex minimises its
+// domain size divided by the summed weights of its constraints to the other
+// unmapped vertices.  The weights persist for the whole search.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename Bitset = boost::dynamic_bitset<>>
+void forwardchecking_bitset_domwdeg_degreeprune_countingalldifferent_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    using bits_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<Bitset, Bitset>,
+        std::tuple<Bitset>>;
+
+    std::vector<bits_type> h_bits;
+    std::vector<bits_type> h_c_bits;
+    void build_h_bits() {
+      for (IndexH i=0; i<n; ++i) {
+        std::get<0>(h_bits[i]).resize(n);
+        std::get<0>(h_c_bits[i]).resize(n);
+        if constexpr (is_directed_v<H>) {
+          std::get<1>(h_bits[i]).resize(n);
+          std::get<1>(h_c_bits[i]).resize(n);
+        }
+      }
+
+      for (IndexH i=0; i<n; ++i) {
+        for (IndexH j=0; j<n; ++j) {
+          if (h.edge(i, j)) {
+            std::get<0>(h_bits[i]).set(j);
+            if constexpr (is_directed_v<H>) {
+              std::get<1>(h_bits[j]).set(i);
+            }
+          } else {
+            std::get<0>(h_c_bits[i]).set(j);
+            if constexpr (is_directed_v<H>) {
+              std::get<1>(h_c_bits[j]).set(i);
+            }
+          }
+        }
+      }
+    }
+
+    IndexG level;
+
+    std::vector<IndexG> index_order_g;
+
+    std::vector<IndexH> map;
+
+    std::vector<Bitset> M;
+    void build_M() {
+      for (IndexG u=0; u<m; ++u) {
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv(g, u, h, v) &&
+              degree_condition(g, u, h, v)) {
+            M[u].set(v);
+          }
+        }
+      }
+    }
+    multi_stack<std::tuple<IndexG, Bitset>> M_mst;
+
+    Bitset hall_set;
+    Bitset work_set;
+
+    std::vector<std::size_t> weights;
+    void bump_weight(IndexG u, IndexG v) {
+      ++weights[u*m + v];
+      ++weights[v*m + u];
+    }
+    std::size_t wdeg(IndexG u) {
+      std::size_t result = 0;
+      for (IndexG i=level; i<m; ++i) {
+        auto v = index_order_g[i];
+        if (v != u) {
+          result += weights[u*m + v];
+        }
+      }
+      return std::max<std::size_t>(result, 1);
+    }
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          h_bits(n),
+          h_c_bits(n),
+          level{0},
+          index_order_g(m),
+          map(m, n),
+          M(m, Bitset(n)),
+          M_mst(m*n, m),
+          hall_set(n),
+          work_set(n),
+          weights(m * m, 1) {
+      build_h_bits();
+      std::iota(index_order_g.begin(), index_order_g.end(), 0);
+      build_M();
+      std::sort(index_order_g.begin(), index_order_g.end(), [this](auto a, auto b) {
+        return M[a].count() < M[b].count();
+      });
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto it = std::next(index_order_g.begin(), level);
+        double it_score = double(M[*it].count()) / wdeg(*it);
+        for (auto jt=std::next(it); jt!=index_order_g.end(); ++jt) {
+          double jt_score = double(M[*jt].count()) / wdeg(*jt);
+          if (std::forward_as_tuple(jt_score, g.degree(*jt), *jt) < std::forward_as_tuple(it_score, g.degree(*it), *it)) {
+            it = jt;
+            it_score = jt_score;
+          }
+        }
+        std::swap(index_order_g[level], *it);
+        auto x = index_order_g[level];
+        bool proceed = true;
+        for (auto y=M[x].find_first(); y!=Bitset::npos; y=M[x].find_next(y)) {
+          M_mst.push_level();
+          if (forward_check(y) &&
+              (std::sort(std::next(index_order_g.begin(), level+1), index_order_g.end(), [this](auto a, auto b) {
+                return std::forward_as_tuple(M[a].count(), g.degree(a), a) < std::forward_as_tuple(M[b].count(), g.degree(b), b);
+              }), counting_all_different())) {
+            map[x] = y;
+            ++level;
+            proceed = explore();
+            --level;
+            map[x] = n;
+          }
+          revert_M();
+          M_mst.pop_level();
+          if (!proceed) {
+            break;
+          }
+        }
+        return proceed;
+      }
+    }
+
+    bool forward_check(IndexH y) {
+      auto x = index_order_g[level];
+
+      bool not_empty = true;
+      for (IndexG i=level+1; i<m && not_empty; ++i) {
+        auto u = index_order_g[i];
+
+        M_mst.push({u, M[u]});
+
+        M[u].reset(y);
+        if constexpr (is_directed_v<G>) {
+          if (g.edge(x, u)) {
+            M[u] &= std::get<0>(h_bits[y]);
+          } else {
+            M[u] &= std::get<0>(h_c_bits[y]);
+          }
+          if (g.edge(u, x)) {
+            not_empty = bitset_and_any(M[u], std::get<1>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<1>(h_c_bits[y]));
+          }
+        } else {
+          if (g.edge(x, u)) {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_c_bits[y]));
+          }
+        }
+        if (!not_empty) {
+          bump_weight(x, u);
+        }
+      }
+      return not_empty;
+    }
+
+    bool counting_all_different() {
+      hall_set.reset();
+      work_set.reset();
+      IndexG count = 0;
+      for (IndexG i=level+1; i<m; ++i) {
+        auto u = index_order_g[i];
+        if (!bitset_and_not_any(M[u], hall_set)) {
+          bump_weight(index_order_g[level], u);
+          return false;
+        }
+        ++count;
+        auto work_set_count = bitset_or_count(work_set, M[u]);
+        if (work_set_count < count) {
+          // the last count vertices share too few values
+          for (IndexG j=i+1-count; j<=i; ++j) {
+            bump_weight(index_order_g[level], index_order_g[j]);
+          }
+          return false;
+        } else if (work_set_count == count) {
+          hall_set |= work_set;
+          count = 0;
+          work_set.reset();
+        }
+      }
+      return true;
+    }
+
+    void revert_M() {
+      while (!M_mst.level_empty()) {
+        auto & [u, row] = M_mst.top();
+        M[u] = row;
+        M_mst.pop();
+      }
+    }
+  } e(g, h, callback, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_FORWARDCHECKING_BITSET_DOMWDEG_DEGREEPRUNE_COUNTINGALLDIFFERENT_IND_H_
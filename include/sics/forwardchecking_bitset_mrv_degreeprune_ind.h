@@ -1,6 +1,8 @@
 #ifndef SICS_FORWARDCHECKING_BITSET_MRV_DEGREEPRUNE_IND_H_
 #define SICS_FORWARDCHECKING_BITSET_MRV_DEGREEPRUNE_IND_H_
 
+#include <cstddef>
+
 #include <iterator>
 #include <tuple>
 #include <numeric>
@@ -8,10 +10,13 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include "bitset_operations.h"
+
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
 #include "multi_stack.h"
+#include "value_order.h"
 
 #include "stats.h"
 
@@ -22,13 +27,16 @@ template <
     typename H,
     typename Callback,
     typename VertexEquiv = default_vertex_label_equiv<G, H>,
-    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename ValueOrder = natural_value_order,
+    typename Bitset = boost::dynamic_bitset<>>
 void forwardchecking_bitset_mrv_degreeprune_ind(
     G const & g,
     H const & h,
     Callback const & callback,
     VertexEquiv const & vertex_equiv = VertexEquiv(),
-    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+    EdgeEquiv const & edge_equiv = EdgeEquiv(),
+    ValueOrder const & value_order = ValueOrder()) {
 
   using IndexG = typename G::index_type;
   using IndexH = typename H::index_type;
@@ -47,8 +55,8 @@ void forwardchecking_bitset_mrv_degreeprune_ind(
 
     using bits_type = std::conditional_t<
         is_directed_v<H>,
-        std::tuple<boost::dynamic_bitset<>, boost::dynamic_bitset<>>,
-        std::tuple<boost::dynamic_bitset<>>>;
+        std::tuple<Bitset, Bitset>,
+        std::tuple<Bitset>>;
 
     std::vector<bits_type> h_bits;
     std::vector<bits_type> h_c_bits;
@@ -85,7 +93,7 @@ void forwardchecking_bitset_mrv_degreeprune_ind(
 
     std::vector<IndexH> map;
 
-    std::vector<boost::dynamic_bitset<>> M;
+    std::vector<Bitset> M;
     void build_M() {
       for (IndexG u=0; u<m; ++u) {
         for (IndexH v=0; v<n; ++v) {
@@ -96,14 +104,18 @@ void forwardchecking_bitset_mrv_degreeprune_ind(
         }
       }
     }
-    multi_stack<std::tuple<IndexG, boost::dynamic_bitset<>>> M_mst;
+    multi_stack<std::tuple<IndexG, Bitset>> M_mst;
+
+    typename ValueOrder::template ranker<G, H> value_rank;
+    std::vector<std::vector<IndexH>> candidates;
 
     explorer(
         G const & g,
         H const & h,
         Callback const & callback,
         VertexEquiv const & vertex_equiv,
-        EdgeEquiv const & edge_equiv)
+        EdgeEquiv const & edge_equiv,
+        ValueOrder const & value_order)
         : g{g},
           h{h},
           callback{callback},
@@ -117,8 +129,10 @@ void forwardchecking_bitset_mrv_degreeprune_ind(
           level{0},
           index_order_g(m),
           map(m, n),
-          M(m, boost::dynamic_bitset<>(n)),
-          M_mst(m*n, m) {
+          M(m, Bitset(n)),
+          M_mst(m*n, m),
+          value_rank(value_order, g, h),
+          candidates(m) {
       build_h_bits();
       std::iota(index_order_g.begin(), index_order_g.end(), 0);
       build_M();
@@ -138,25 +152,69 @@ void forwardchecking_bitset_mrv_degreeprune_ind(
         std::swap(index_order_g[level], *it);
         auto x = index_order_g[level];
         bool proceed = true;
-        for (auto y=M[x].find_first(); y!=boost::dynamic_bitset<>::npos; y=M[x].find_next(y)) {
-          M_mst.push_level();
-          if (forward_check(y)) {
-            map[x] = y;
-            ++level;
-            proceed = explore();
-            --level;
-            map[x] = n;
+        if constexpr (ValueOrder::is_ordered) {
+          auto & ys = candidates[level];
+          ys.clear();
+          for (auto y=M[x].find_first(); y!=Bitset::npos; y=M[x].find_next(y)) {
+            ys.push_back(y);
           }
-          revert_M();
-          M_mst.pop_level();
-          if (!proceed) {
-            break;
+          order_values(value_rank, ys, [this](IndexH y) {
+            return removals(y);
+          });
+          for (auto y : ys) {
+            proceed = extend(x, y);
+            if (!proceed) {
+              break;
+            }
+          }
+        } else {
+          for (auto y=M[x].find_first(); y!=Bitset::npos; y=M[x].find_next(y)) {
+            proceed = extend(x, y);
+            if (!proceed) {
+              break;
+            }
           }
         }
         return proceed;
       }
     }
 
+    bool extend(IndexG x, IndexH y) {
+      bool proceed = true;
+      M_mst.push_level();
+      if (forward_check(y)) {
+        map[x] = y;
+        ++level;
+        proceed = explore();
+        --level;
+        map[x] = n;
+      }
+      revert_M();
+      M_mst.pop_level();
+      return proceed;
+    }
+
+    // Number of values forward_check(y) would remove from the future
+    // domains.
+    std::size_t removals(IndexH y) {
+      auto x = index_order_g[level];
+
+      std::size_t result = 0;
+      Bitset row;
+      for (IndexG i=level+1; i<m; ++i) {
+        auto u = index_order_g[i];
+
+        row = M[u];
+        row.reset(y);
+        row &= g.edge(x, u) ? std::get<0>(h_bits[y]) : std::get<0>(h_c_bits[y]);
+        if constexpr (is_directed_v<G>) {
+          row &= g.edge(u, x) ? std::get<1>(h_bits[y]) : std::get<1>(h_c_bits[y]);
+        }
+        result += M[u].count() - row.count();
+      }
+      return result;
+    }
+
     bool forward_check(IndexH y) {
       auto x = index_order_g[level];
 
@@ -167,21 +225,24 @@ void forwardchecking_bitset_mrv_degreeprune_ind(
         M_mst.push({u, M[u]});
 
         M[u].reset(y);
-        if (g.edge(x, u)) {
-          M[u] &= std::get<0>(h_bits[y]);
-        } else {
-          M[u] &= std::get<0>(h_c_bits[y]);
-        }
-
         if constexpr (is_directed_v<G>) {
+          if (g.edge(x, u)) {
+            M[u] &= std::get<0>(h_bits[y]);
+          } else {
+            M[u] &= std::get<0>(h_c_bits[y]);
+          }
           if (g.edge(u, x)) {
-            M[u] &= std::get<1>(h_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_bits[y]));
           } else {
-            M[u] &= std::get<1>(h_c_bits[y]);
+            not_empty = bitset_and_any(M[u], std::get<1>(h_c_bits[y]));
+          }
+        } else {
+          if (g.edge(x, u)) {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_c_bits[y]));
           }
         }
-
-        not_empty = M[u].any();
       }
       return not_empty;
     }
@@ -193,7 +254,7 @@ void forwardchecking_bitset_mrv_degreeprune_ind(
         M_mst.pop();
       }
     }
-  } e(g, h, callback, vertex_equiv, edge_equiv);
+  } e(g, h, callback, vertex_equiv, edge_equiv, value_order);
 
   e.explore();
 }
@@ -0,0 +1,350 @@
+#ifndef SICS_FORWARDCHECKING_BITSET_MRV_DEGREEPRUNE_RESTARTS_IND_H_
+#define SICS_FORWARDCHECKING_BITSET_MRV_DEGREEPRUNE_RESTARTS_IND_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "bitset_operations.h"
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "multi_stack.h"
+#include "nogood_store.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// forwardchecking_bitset_mrv_degreeprune_ind with randomised restarts.
+//
+// MRV ties are broken by a random key drawn at every restart, and the
+// candidates of a vertex are tried starting from a random position.  A run
+// is abandoned once it has made restart_base * luby(r) calls to explore().
+// Before the next run, every value whose subtree was finished is turned into
+// a nogood: the decisions above it plus the value itself.  All solutions
+// below such a value have been reported, so later runs skip any assignment
+// containing a nogood.  Each run finishes at least one new subtree and the
+// budgets grow without bound, so the search stays complete and enumerates
+// every solution exactly once.
+//
+// The nogoods are kept in a nogood_store of at most nogood_capacity
+// entries.  Dropping one would report its solutions again, so the store is
+// never reduced: once the nogoods of a restart would not fit, the current
+// run goes on without a budget and is the last one.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename Bitset = boost::dynamic_bitset<>>
+void forwardchecking_bitset_mrv_degreeprune_restarts_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv(),
+    std::size_t restart_base = 256,
+    unsigned seed = 0,
+    std::size_t nogood_capacity = 100000) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    using bits_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<Bitset, Bitset>,
+        std::tuple<Bitset>>;
+
+    std::vector<bits_type> h_bits;
+    std::vector<bits_type> h_c_bits;
+    void build_h_bits() {
+      for (IndexH i=0; i<n; ++i) {
+        std::get<0>(h_bits[i]).resize(n);
+        std::get<0>(h_c_bits[i]).resize(n);
+        if constexpr (is_directed_v<H>) {
+          std::get<1>(h_bits[i]).resize(n);
+          std::get<1>(h_c_bits[i]).resize(n);
+        }
+      }
+
+      for (IndexH i=0; i<n; ++i) {
+        for (IndexH j=0; j<n; ++j) {
+          if (h.edge(i, j)) {
+            std::get<0>(h_bits[i]).set(j);
+            if constexpr (is_directed_v<H>) {
+              std::get<1>(h_bits[j]).set(i);
+            }
+          } else {
+            std::get<0>(h_c_bits[i]).set(j);
+            if constexpr (is_directed_v<H>) {
+              std::get<1>(h_c_bits[j]).set(i);
+            }
+          }
+        }
+      }
+    }
+
+    IndexG level;
+
+    std::vector<IndexG> index_order_g;
+
+    std::vector<IndexH> map;
+
+    std::vector<Bitset> M;
+    void build_M() {
+      for (IndexG u=0; u<m; ++u) {
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv(g, u, h, v) &&
+              degree_condition(g, u, h, v)) {
+            M[u].set(v);
+          }
+        }
+      }
+    }
+    multi_stack<std::tuple<IndexG, Bitset>> M_mst;
+
+    std::mt19937 rng;
+    std::vector<std::uint32_t> tie_keys;
+
+    std::size_t restart_base;
+    std::size_t budget;
+    std::size_t calls;
+    bool restarting;
+
+    // completed[l]: values of the vertex at level l whose subtrees were
+    // finished under the current decisions
+    std::vector<std::vector<IndexH>> completed;
+
+    nogood_store<IndexG, IndexH> nogoods;
+    std::vector<std::pair<IndexG, IndexH>> nogood;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv,
+        std::size_t restart_base,
+        unsigned seed,
+        std::size_t nogood_capacity)
+        : g{g},
+          h{h},
+          callback{callback},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          h_bits(n),
+          h_c_bits(n),
+          level{0},
+          index_order_g(m),
+          map(m, n),
+          M(m, Bitset(n)),
+          M_mst(m*n, m),
+          rng(seed),
+          tie_keys(m),
+          restart_base{std::max<std::size_t>(restart_base, 1)},
+          budget{0},
+          calls{0},
+          restarting{false},
+          completed(m),
+          nogoods(m, n, nogood_capacity) {
+      build_h_bits();
+      std::iota(index_order_g.begin(), index_order_g.end(), 0);
+      build_M();
+    }
+
+    // 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+    static std::size_t luby(std::size_t i) {
+      while (true) {
+        std::size_t k = 1;
+        while ((std::size_t{1} << k) - 1 < i) {
+          ++k;
+        }
+        if (i == (std::size_t{1} << k) - 1) {
+          return std::size_t{1} << (k - 1);
+        }
+        i -= (std::size_t{1} << (k - 1)) - 1;
+      }
+    }
+
+    void run() {
+      for (std::size_t r=1; ; ++r) {
+        budget = restart_base * luby(r);
+        calls = 0;
+        restarting = false;
+        for (auto & key : tie_keys) {
+          key = rng();
+        }
+        explore();
+        if (!restarting) {
+          return;
+        }
+      }
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (++calls > budget) {
+        if (!fits_nogoods()) {
+          budget = std::numeric_limits<std::size_t>::max();
+        } else {
+          restarting = true;
+          return false;
+        }
+      }
+      if (level == m) {
+        return callback();
+      } else {
+        auto it = std::min_element(
+            std::next(index_order_g.begin(), level),
+            index_order_g.end(),
+            [this](auto a, auto b) {
+              return std::forward_as_tuple(M[a].count(), g.degree(a), tie_keys[a]) < std::forward_as_tuple(M[b].count(), g.degree(b), tie_keys[b]);
+            });
+        std::swap(index_order_g[level], *it);
+        auto x = index_order_g[level];
+        completed[level].clear();
+        bool proceed = true;
+
+        IndexH start = n ? static_cast<IndexH>(std::uniform_int_distribution<std::size_t>(0, n-1)(rng)) : 0;
+        auto y = start < n && M[x].test(start) ? start : M[x].find_next(start);
+        bool wrapped = false;
+        while (true) {
+          if (y == Bitset::npos) {
+            if (wrapped) {
+              break;
+            }
+            wrapped = true;
+            y = M[x].find_first();
+            continue;
+          }
+          if (wrapped && y >= start) {
+            break;
+          }
+          if (nogoods.find_violated(x, y, map) == nogoods.npos) {
+            M_mst.push_level();
+            if (forward_check(y)) {
+              map[x] = y;
+              ++level;
+              proceed = explore();
+              --level;
+              map[x] = n;
+              if (!restarting) {
+                completed[level].push_back(y);
+              }
+            }
+            revert_M();
+            M_mst.pop_level();
+            if (!proceed) {
+              break;
+            }
+          }
+          y = M[x].find_next(y);
+        }
+
+        if (restarting) {
+          record_nogoods();
+        }
+        return proceed;
+      }
+    }
+
+    // whether the store has room for the nogoods a restart from this level
+    // would record
+    bool fits_nogoods() {
+      std::size_t pending = 0;
+      for (IndexG i=0; i<level; ++i) {
+        pending += completed[i].size();
+      }
+      return nogoods.size() + pending <= nogoods.capacity();
+    }
+
+    void record_nogoods() {
+      auto x = index_order_g[level];
+      nogood.clear();
+      for (IndexG i=0; i<level; ++i) {
+        auto u = index_order_g[i];
+        nogood.emplace_back(u, map[u]);
+      }
+      nogood.emplace_back(x, n);
+      for (auto y : completed[level]) {
+        nogood.back().second = y;
+        nogoods.add(nogood.cbegin(), nogood.cend());
+      }
+      completed[level].clear();
+    }
+
+    bool forward_check(IndexH y) {
+      auto x = index_order_g[level];
+
+      bool not_empty = true;
+      for (IndexG i=level+1; i<m && not_empty; ++i) {
+        auto u = index_order_g[i];
+
+        M_mst.push({u, M[u]});
+
+        M[u].reset(y);
+        if constexpr (is_directed_v<G>) {
+          if (g.edge(x, u)) {
+            M[u] &= std::get<0>(h_bits[y]);
+          } else {
+            M[u] &= std::get<0>(h_c_bits[y]);
+          }
+          if (g.edge(u, x)) {
+            not_empty = bitset_and_any(M[u], std::get<1>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<1>(h_c_bits[y]));
+          }
+        } else {
+          if (g.edge(x, u)) {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_bits[y]));
+          } else {
+            not_empty = bitset_and_any(M[u], std::get<0>(h_c_bits[y]));
+          }
+        }
+      }
+      return not_empty;
+    }
+
+    void revert_M() {
+      while (!M_mst.level_empty()) {
+        auto & [u, row] = M_mst.top();
+        M[u] = row;
+        M_mst.pop();
+      }
+    }
+  } e(g, h, callback, vertex_equiv, edge_equiv, restart_base, seed, nogood_capacity);
+
+  e.run();
+}
+
+}  // namespace sics
+
+#endif  // SICS_FORWARDCHECKING_BITSET_MRV_DEGREEPRUNE_RESTARTS_IND_H_
@@ -0,0 +1,197 @@
+#ifndef SICS_FORWARDCHECKING_COMPRESSEDBITSET_MRV_DEGREEPRUNE_IND_H_
+#define SICS_FORWARDCHECKING_COMPRESSEDBITSET_MRV_DEGREEPRUNE_IND_H_
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <numeric>
+#include <vector>
+
+#include "hierarchical_bitset.h"
+#include "compressed_bitset.h"
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "multi_stack.h"
+
+#include "stats.h"
+
+namespace sics {
+
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void forwardchecking_compressedbitset_mrv_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    using bits_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<compressed_bitset, compressed_bitset>,
+        std::tuple<compressed_bitset>>;
+
+    std::vector<bits_type> h_bits;
+    void build_h_bits() {
+      std::vector<IndexH> row;
+      for (IndexH i=0; i<n; ++i) {
+        row.clear();
+        for (auto oe : edges_or_out_edges(h, i)) {
+          row.push_back(oe.target);
+        }
+        std::sort(row.begin(), row.end());
+        std::get<0>(h_bits[i]) = compressed_bitset(n, row.cbegin(), row.cend());
+        if constexpr (is_directed_v<H>) {
+          row.clear();
+          for (auto ie : h.in_edges(i)) {
+            row.push_back(ie.target);
+          }
+          std::sort(row.begin(), row.end());
+          std::get<1>(h_bits[i]) = compressed_bitset(n, row.cbegin(), row.cend());
+        }
+      }
+    }
+
+    IndexG level;
+
+    std::vector<IndexG> index_order_g;
+
+    std::vector<IndexH> map;
+
+    std::vector<hierarchical_bitset> M;
+    void build_M() {
+      for (IndexG u=0; u<m; ++u) {
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv(g, u, h, v) &&
+              degree_condition(g, u, h, v)) {
+            M[u].set(v);
+          }
+        }
+      }
+    }
+    multi_stack<std::tuple<IndexG, hierarchical_bitset>> M_mst;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          h_bits(n),
+          level{0},
+          index_order_g(m),
+          map(m, n),
+          M(m, hierarchical_bitset(n)),
+          M_mst(m*m, m) {
+      build_h_bits();
+      std::iota(index_order_g.begin(), index_order_g.end(), 0);
+      build_M();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto it = std::min_element(
+            std::next(index_order_g.begin(), level),
+            index_order_g.end(),
+            [this](auto a, auto b) {
+              return std::forward_as_tuple(M[a].count(), g.degree(a), a) < std::forward_as_tuple(M[b].count(), g.degree(b), b);
+            });
+        std::swap(index_order_g[level], *it);
+        auto x = index_order_g[level];
+        bool proceed = true;
+        for (auto y=M[x].find_first(); y!=hierarchical_bitset::npos; y=M[x].find_next(y)) {
+          M_mst.push_level();
+          if (forward_check(y)) {
+            map[x] = y;
+            ++level;
+            proceed = explore();
+            --level;
+            map[x] = n;
+          }
+          revert_M();
+          M_mst.pop_level();
+          if (!proceed) {
+            break;
+          }
+        }
+        return proceed;
+      }
+    }
+
+    bool forward_check(IndexH y) {
+      auto x = index_order_g[level];
+
+      bool not_empty = true;
+      for (IndexG i=level+1; i<m && not_empty; ++i) {
+        auto u = index_order_g[i];
+
+        M_mst.push({u, M[u]});
+
+        M[u].reset(y);
+        if (g.edge(x, u)) {
+          and_assign(M[u], std::get<0>(h_bits[y]));
+        } else {
+          and_not_assign(M[u], std::get<0>(h_bits[y]));
+        }
+
+        if constexpr (is_directed_v<G>) {
+          if (g.edge(u, x)) {
+            and_assign(M[u], std::get<1>(h_bits[y]));
+          } else {
+            and_not_assign(M[u], std::get<1>(h_bits[y]));
+          }
+        }
+
+        not_empty = M[u].any();
+      }
+      return not_empty;
+    }
+
+    void revert_M() {
+      while (!M_mst.level_empty()) {
+        auto & [u, row] = M_mst.top();
+        M[u] = row;
+        M_mst.pop();
+      }
+    }
+  } e(g, h, callback, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_FORWARDCHECKING_COMPRESSEDBITSET_MRV_DEGREEPRUNE_IND_H_
@@ -0,0 +1,37 @@
+#ifndef SICS_FORWARDCHECKING_FIXEDBITSET_MRV_DEGREEPRUNE_COUNTINGALLDIFFERENT_IND_H_
+#define SICS_FORWARDCHECKING_FIXEDBITSET_MRV_DEGREEPRUNE_COUNTINGALLDIFFERENT_IND_H_
+
+#include "fixed_bitset.h"
+#include "forwardchecking_blockbitset_mrv_degreeprune_countingalldifferent_ind.h"
+
+namespace sics {
+
+// Runs forwardchecking_blockbitset_mrv_degreeprune_countingalldifferent_ind with the
+// narrowest fixed_bitset that holds the target, falling back to block_bitset
+// for targets with more than 512 vertices.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void forwardchecking_fixedbitset_mrv_degreeprune_countingalldifferent_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  dispatch_bitset(h.num_vertices(), [&](auto tag) {
+    using Bitset = typename decltype(tag)::type;
+    forwardchecking_blockbitset_mrv_degreeprune_countingalldifferent_ind<G, H, Callback, VertexEquiv, EdgeEquiv, Bitset>(
+        g,
+        h,
+        callback,
+        vertex_equiv,
+        edge_equiv);
+  });
+}
+
+}  // namespace sics
+
+#endif  // SICS_FORWARDCHECKING_FIXEDBITSET_MRV_DEGREEPRUNE_COUNTINGALLDIFFERENT_IND_H_
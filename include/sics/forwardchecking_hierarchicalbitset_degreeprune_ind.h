@@ -0,0 +1,37 @@
+#ifndef SICS_FORWARDCHECKING_HIERARCHICALBITSET_DEGREEPRUNE_IND_H_
+#define SICS_FORWARDCHECKING_HIERARCHICALBITSET_DEGREEPRUNE_IND_H_
+
+#include "hierarchical_bitset.h"
+#include "forwardchecking_bitset_degreeprune_ind.h"
+
+namespace sics {
+
+// Runs forwardchecking_bitset_degreeprune_ind with hierarchical_bitset
+// domains, for large sparse targets whose rows are mostly empty blocks.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void forwardchecking_hierarchicalbitset_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  forwardchecking_bitset_degreeprune_ind<
+      G, H, Callback, IndexOrderG, VertexEquiv, EdgeEquiv, natural_value_order, hierarchical_bitset>(
+      g,
+      h,
+      callback,
+      index_order_g,
+      vertex_equiv,
+      edge_equiv);
+}
+
+}  // namespace sics
+
+#endif  // SICS_FORWARDCHECKING_HIERARCHICALBITSET_DEGREEPRUNE_IND_H_
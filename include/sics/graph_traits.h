@@ -45,6 +45,17 @@ struct is_edge_labelled {
 };
 template <typename G> inline constexpr bool is_edge_labelled_v = is_edge_labelled<G>::value;
 
+// Graphs whose neighbour lists are sorted by descending degree declare
+// using neighbour_order = degree_sorted_tag;
+struct degree_sorted_tag {};
+
+template <typename G, typename SFINAE = void>
+struct is_degree_sorted : public std::false_type {};
+template <typename G>
+struct is_degree_sorted<G, std::void_t<typename G::neighbour_order>>
+    : public std::is_same<degree_sorted_tag, typename G::neighbour_order> {};
+template <typename G> inline constexpr bool is_degree_sorted_v = is_degree_sorted<G>::value;
+
 }  // namespace sics
 
 #endif  // SICS_GRAPH_TRAITS_H_
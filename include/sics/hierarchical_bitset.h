@@ -0,0 +1,276 @@
+#ifndef SICS_HIERARCHICAL_BITSET_H_
+#define SICS_HIERARCHICAL_BITSET_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+namespace sics {
+
+// A bitset with a summary layer: bit i of the summary is set iff block i is
+// non-zero.  Iteration, emptiness tests and the in-place operators only visit
+// the blocks marked in the summary, so a sparse set in a very long row is
+// handled in time proportional to the number of non-empty blocks (plus one
+// summary bit per block).
+//
+// The interface follows boost::dynamic_bitset<> closely enough to be used as
+// a drop-in replacement in the bitset engines.
+class hierarchical_bitset {
+ public:
+  using block_type = std::uint64_t;
+  using size_type = std::size_t;
+
+  static constexpr size_type bits_per_block = 64;
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+ private:
+  size_type m_num_bits;
+  std::vector<block_type> m_blocks;
+  std::vector<block_type> m_summary;
+
+  static size_type block_index(size_type pos) {
+    return pos / bits_per_block;
+  }
+
+  static size_type bit_index(size_type pos) {
+    return pos % bits_per_block;
+  }
+
+  static size_type num_blocks_for(size_type num_bits) {
+    return (num_bits + bits_per_block - 1) / bits_per_block;
+  }
+
+  static int lowest_bit(block_type block) {
+    return __builtin_ctzll(block);
+  }
+
+  static size_type popcount(block_type block) {
+    return __builtin_popcountll(block);
+  }
+
+  void mark(size_type b) {
+    m_summary[block_index(b)] |= block_type{1} << bit_index(b);
+  }
+
+  void unmark(size_type b) {
+    m_summary[block_index(b)] &= ~(block_type{1} << bit_index(b));
+  }
+
+  // Calls f(b) for every block b marked in the summary, in increasing order.
+  // f may unmark b.
+  template <typename F>
+  void for_each_block(F f) const {
+    for (size_type s=0; s<m_summary.size(); ++s) {
+      auto word = m_summary[s];
+      while (word) {
+        f(s * bits_per_block + lowest_bit(word));
+        word &= word - 1;
+      }
+    }
+  }
+
+  size_type find_from_block(size_type b) const {
+    auto nb = find_block(b);
+    if (nb == npos) {
+      return npos;
+    }
+    return nb * bits_per_block + lowest_bit(m_blocks[nb]);
+  }
+
+ public:
+  hierarchical_bitset()
+      : m_num_bits{0} {
+  }
+
+  explicit hierarchical_bitset(size_type num_bits)
+      : m_num_bits{num_bits},
+        m_blocks(num_blocks_for(num_bits), 0),
+        m_summary(num_blocks_for(num_blocks_for(num_bits)), 0) {
+  }
+
+  void resize(size_type num_bits) {
+    if (num_bits < m_num_bits && bit_index(num_bits) != 0) {
+      m_blocks[block_index(num_bits)] &= ~(~block_type{0} << bit_index(num_bits));
+    }
+    m_num_bits = num_bits;
+    m_blocks.resize(num_blocks_for(num_bits), 0);
+    m_summary.assign(num_blocks_for(m_blocks.size()), 0);
+    for (size_type b=0; b<m_blocks.size(); ++b) {
+      if (m_blocks[b]) {
+        mark(b);
+      }
+    }
+  }
+
+  size_type size() const {
+    return m_num_bits;
+  }
+
+  size_type num_blocks() const {
+    return m_blocks.size();
+  }
+
+  block_type block(size_type b) const {
+    return m_blocks[b];
+  }
+
+  // Replaces block b, keeping the summary up to date.  Bits past size() must
+  // be zero.
+  void set_block(size_type b, block_type value) {
+    m_blocks[b] = value;
+    if (value) {
+      mark(b);
+    } else {
+      unmark(b);
+    }
+  }
+
+  bool block_marked(size_type b) const {
+    return (m_summary[block_index(b)] >> bit_index(b)) & 1;
+  }
+
+  // Index of the first non-empty block at or after b, or npos.
+  size_type find_block(size_type b) const {
+    auto s = block_index(b);
+    if (s >= m_summary.size()) {
+      return npos;
+    }
+    auto word = m_summary[s] & (~block_type{0} << bit_index(b));
+    while (!word) {
+      if (++s == m_summary.size()) {
+        return npos;
+      }
+      word = m_summary[s];
+    }
+    return s * bits_per_block + lowest_bit(word);
+  }
+
+  bool test(size_type pos) const {
+    return (m_blocks[block_index(pos)] >> bit_index(pos)) & 1;
+  }
+
+  bool operator[](size_type pos) const {
+    return test(pos);
+  }
+
+  hierarchical_bitset & set(size_type pos) {
+    auto b = block_index(pos);
+    m_blocks[b] |= block_type{1} << bit_index(pos);
+    mark(b);
+    return *this;
+  }
+
+  hierarchical_bitset & set() {
+    for (size_type b=0; b<m_blocks.size(); ++b) {
+      m_blocks[b] = ~block_type{0};
+      mark(b);
+    }
+    if (bit_index(m_num_bits) != 0) {
+      m_blocks.back() &= ~(~block_type{0} << bit_index(m_num_bits));
+    }
+    return *this;
+  }
+
+  hierarchical_bitset & reset(size_type pos) {
+    auto b = block_index(pos);
+    m_blocks[b] &= ~(block_type{1} << bit_index(pos));
+    if (!m_blocks[b]) {
+      unmark(b);
+    }
+    return *this;
+  }
+
+  hierarchical_bitset & reset() {
+    for_each_block([this](size_type b) {
+      m_blocks[b] = 0;
+    });
+    std::fill(m_summary.begin(), m_summary.end(), 0);
+    return *this;
+  }
+
+  bool any() const {
+    for (auto word : m_summary) {
+      if (word) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool none() const {
+    return !any();
+  }
+
+  size_type count() const {
+    size_type result = 0;
+    for_each_block([this, &result](size_type b) {
+      result += popcount(m_blocks[b]);
+    });
+    return result;
+  }
+
+  size_type find_first() const {
+    return find_from_block(0);
+  }
+
+  size_type find_next(size_type pos) const {
+    ++pos;
+    if (pos >= m_num_bits) {
+      return npos;
+    }
+    auto b = block_index(pos);
+    auto rest = m_blocks[b] & (~block_type{0} << bit_index(pos));
+    if (rest) {
+      return b * bits_per_block + lowest_bit(rest);
+    }
+    return find_from_block(b + 1);
+  }
+
+  hierarchical_bitset & operator&=(hierarchical_bitset const & other) {
+    for_each_block([this, &other](size_type b) {
+      m_blocks[b] &= other.m_blocks[b];
+      if (!m_blocks[b]) {
+        unmark(b);
+      }
+    });
+    return *this;
+  }
+
+  hierarchical_bitset & operator|=(hierarchical_bitset const & other) {
+    other.for_each_block([this, &other](size_type b) {
+      m_blocks[b] |= other.m_blocks[b];
+      mark(b);
+    });
+    return *this;
+  }
+
+  // Set difference, *this & ~other.
+  hierarchical_bitset & operator-=(hierarchical_bitset const & other) {
+    for (size_type s=0; s<m_summary.size(); ++s) {
+      auto word = m_summary[s] & other.m_summary[s];
+      while (word) {
+        auto b = s * bits_per_block + lowest_bit(word);
+        m_blocks[b] &= ~other.m_blocks[b];
+        if (!m_blocks[b]) {
+          unmark(b);
+        }
+        word &= word - 1;
+      }
+    }
+    return *this;
+  }
+
+  friend bool operator==(hierarchical_bitset const & a, hierarchical_bitset const & b) {
+    return a.m_num_bits == b.m_num_bits && a.m_summary == b.m_summary && a.m_blocks == b.m_blocks;
+  }
+
+  friend bool operator!=(hierarchical_bitset const & a, hierarchical_bitset const & b) {
+    return !(a == b);
+  }
+};
+
+}  // namespace sics
+
+#endif  // SICS_HIERARCHICAL_BITSET_H_
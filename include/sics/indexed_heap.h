@@ -0,0 +1,110 @@
+#ifndef SICS_INDEXED_HEAP_H_
+#define SICS_INDEXED_HEAP_H_
+
+#include <cstddef>
+
+#include <utility>
+#include <vector>
+
+namespace sics {
+
+// A binary max-heap over the indices 0..n-1 that supports changing the key of
+// an index already in the heap.  Keys live outside the heap; Less compares
+// two indices by their current keys, and update(i) must be called after the
+// key of i changes.
+template <
+    typename Index,
+    typename Less>
+class indexed_max_heap {
+ private:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  Less less;
+  std::vector<Index> m_heap;
+  std::vector<std::size_t> m_pos;
+
+  void place(std::size_t p, Index i) {
+    m_heap[p] = i;
+    m_pos[i] = p;
+  }
+
+  void sift_up(std::size_t p) {
+    auto i = m_heap[p];
+    while (p > 0) {
+      auto parent = (p - 1) / 2;
+      if (!less(m_heap[parent], i)) {
+        break;
+      }
+      place(p, m_heap[parent]);
+      p = parent;
+    }
+    place(p, i);
+  }
+
+  void sift_down(std::size_t p) {
+    auto i = m_heap[p];
+    auto size = m_heap.size();
+    while (true) {
+      auto child = 2 * p + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size && less(m_heap[child], m_heap[child+1])) {
+        ++child;
+      }
+      if (!less(i, m_heap[child])) {
+        break;
+      }
+      place(p, m_heap[child]);
+      p = child;
+    }
+    place(p, i);
+  }
+
+ public:
+  indexed_max_heap(Index n, Less less)
+      : less{less},
+        m_pos(n, npos) {
+    m_heap.reserve(n);
+  }
+
+  bool empty() const {
+    return m_heap.empty();
+  }
+
+  bool contains(Index i) const {
+    return m_pos[i] != npos;
+  }
+
+  Index top() const {
+    return m_heap.front();
+  }
+
+  void push(Index i) {
+    m_heap.push_back(i);
+    m_pos[i] = m_heap.size() - 1;
+    sift_up(m_heap.size() - 1);
+  }
+
+  void pop() {
+    auto i = m_heap.front();
+    auto last = m_heap.back();
+    m_heap.pop_back();
+    m_pos[i] = npos;
+    if (!m_heap.empty()) {
+      place(0, last);
+      sift_down(0);
+    }
+  }
+
+  void update(Index i) {
+    if (contains(i)) {
+      sift_up(m_pos[i]);
+      sift_down(m_pos[i]);
+    }
+  }
+};
+
+}  // namespace sics
+
+#endif  // SICS_INDEXED_HEAP_H_
@@ -0,0 +1,282 @@
+#ifndef SICS_LAZYFORWARDCHECKING_BITPARALLEL_IND_H_
+#define SICS_LAZYFORWARDCHECKING_BITPARALLEL_IND_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+#include <stack>
+
+#include "block_bitset.h"
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// lazyforwardchecking_ind with the bit-parallel consistency check of
+// backjumping_bitparallel_ind.  The lowest level in which
+// image_adjacency[y] and earlier_neighbour_levels[level] differ is the
+// earliest one whose adjacency to y is wrong, and y is restored when that
+// level is undone.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void lazyforwardchecking_bitparallel_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    // bitsets over levels; for directed graphs std::get<0> is about
+    // out-neighbours and std::get<1> about in-neighbours
+    using bits_type = std::conditional_t<
+        is_directed_v<G>,
+        std::tuple<block_bitset, block_bitset>,
+        std::tuple<block_bitset>>;
+
+    std::vector<bits_type> earlier_neighbour_levels;
+    void build_earlier_neighbour_levels() {
+      for (IndexG l=0; l<m; ++l) {
+        auto x = index_order_g[l];
+        auto & bits = earlier_neighbour_levels[l];
+        for (IndexG i=0; i<l; ++i) {
+          auto u = index_order_g[i];
+          if (g.edge(x, u)) {
+            std::get<0>(bits).set(i);
+          }
+          if constexpr (is_directed_v<G>) {
+            if (g.edge(u, x)) {
+              std::get<1>(bits).set(i);
+            }
+          }
+        }
+      }
+    }
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+    // image_level[v]: the level whose vertex is mapped to v, or m
+    std::vector<IndexG> image_level;
+
+    std::vector<char> M;
+    bool M_get(IndexG u, IndexH v) {
+      return M[u*n + v];
+    }
+    void M_set(IndexG u, IndexH v) {
+      M[u*n + v] = true;
+    }
+    void M_unset(IndexG u, IndexH v) {
+      M[u*n + v] = false;
+    }
+    void build_M() {
+      for (IndexG u=0; u<m; ++u) {
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv(g, u, h, v)) {
+            M_set(u, v);
+          }
+        }
+      }
+    }
+    std::vector<std::stack<std::pair<IndexG,IndexH>>> M_sts;
+
+    std::vector<bits_type> image_adjacency;
+    void set_image_adjacency(IndexH v) {
+      if constexpr (is_directed_v<H>) {
+        for (auto ie : h.in_edges(v)) {
+          std::get<0>(image_adjacency[ie.target]).set(level);
+        }
+        for (auto oe : h.out_edges(v)) {
+          std::get<1>(image_adjacency[oe.target]).set(level);
+        }
+      } else {
+        for (auto e : h.edges(v)) {
+          std::get<0>(image_adjacency[e.target]).set(level);
+        }
+      }
+    }
+    void reset_image_adjacency(IndexH v) {
+      if constexpr (is_directed_v<H>) {
+        for (auto ie : h.in_edges(v)) {
+          std::get<0>(image_adjacency[ie.target]).reset(level);
+        }
+        for (auto oe : h.out_edges(v)) {
+          std::get<1>(image_adjacency[oe.target]).reset(level);
+        }
+      } else {
+        for (auto e : h.edges(v)) {
+          std::get<0>(image_adjacency[e.target]).reset(level);
+        }
+      }
+    }
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          earlier_neighbour_levels(m),
+          level{0},
+          map(m, n),
+          image_level(n, m),
+          M(m * n, false),
+          M_sts(m),
+          image_adjacency(n) {
+      for (auto & bits : earlier_neighbour_levels) {
+        std::get<0>(bits).resize(m);
+        if constexpr (is_directed_v<G>) {
+          std::get<1>(bits).resize(m);
+        }
+      }
+      for (auto & bits : image_adjacency) {
+        std::get<0>(bits).resize(m);
+        if constexpr (is_directed_v<G>) {
+          std::get<1>(bits).resize(m);
+        }
+      }
+      build_earlier_neighbour_levels();
+      build_M();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+        bool proceed = true;
+        for (IndexH y=0; y<n; ++y) {
+          if (M_get(x, y) &&
+              consistency(y)) {
+            map[x] = y;
+            image_level[y] = level;
+            set_image_adjacency(y);
+            ++level;
+            proceed = explore();
+            --level;
+            reset_image_adjacency(y);
+            image_level[y] = m;
+            map[x] = n;
+            revert_M();
+            if (!proceed) {
+              break;
+            }
+          }
+        }
+        return proceed;
+      }
+    }
+
+    bool consistency(IndexH y) {
+      auto x = index_order_g[level];
+
+      auto c = conflict(y);
+      if (c < level) {
+        M_unset(x, y);
+        M_sts[c].emplace(x, y);
+        return false;
+      }
+      return true;
+    }
+
+    // A level y conflicts with, or level if there is none.
+    IndexG conflict(IndexH y) {
+      auto x = index_order_g[level];
+
+      auto c = std::min(image_level[y], level);
+      auto const & adj = image_adjacency[y];
+      auto const & exp = earlier_neighbour_levels[level];
+      c = std::min(c, first_difference(std::get<0>(adj), std::get<0>(exp)));
+      if constexpr (is_directed_v<G>) {
+        c = std::min(c, first_difference(std::get<1>(adj), std::get<1>(exp)));
+      }
+
+      // any level y conflicts with is a sound culprit, so the edge labels
+      // are only looked at for a y whose adjacency is right
+      if (c == level) {
+        for (auto i=std::get<0>(exp).find_first(); i<c; i=std::get<0>(exp).find_next(i)) {
+          auto u = index_order_g[i];
+          if (!edge_equiv(g, x, u, h, y, map[u])) {
+            return i;
+          }
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto i=std::get<1>(exp).find_first(); i<c; i=std::get<1>(exp).find_next(i)) {
+            auto u = index_order_g[i];
+            if (!edge_equiv(g, u, x, h, map[u], y)) {
+              return i;
+            }
+          }
+        }
+      }
+      return c;
+    }
+
+    // the lowest bit set in exactly one of a and b, or level if there is none
+    IndexG first_difference(block_bitset const & a, block_bitset const & b) {
+      for (std::size_t k=0; k<a.num_blocks(); ++k) {
+        auto d = a.data()[k] ^ b.data()[k];
+        if (d) {
+          return k * block_bitset::bits_per_block + __builtin_ctzll(d);
+        }
+      }
+      return level;
+    }
+
+    void revert_M() {
+      while (!M_sts[level].empty()) {
+        IndexG u;
+        IndexH v;
+        std::tie(u, v) = M_sts[level].top();
+        M_sts[level].pop();
+        M_set(u, v);
+      }
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_LAZYFORWARDCHECKING_BITPARALLEL_IND_H_
@@ -8,6 +8,7 @@
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
+#include "parent_candidates.h"
 
 #include "stats.h"
 
@@ -110,6 +111,8 @@ void lazyforwardchecking_low_parent_degreeprune_ind(
     }
     std::vector<std::stack<std::pair<IndexG,IndexH>>> M_sts;
 
+    parent_candidates<G, H, VertexEquiv> candidates;
+
     explorer(
         G const & g,
         H const & h,
@@ -131,7 +134,8 @@ void lazyforwardchecking_low_parent_degreeprune_ind(
           parents(m),
           low(m, 0),
           M(m * n, false),
-          M_sts(m) {
+          M_sts(m),
+          candidates(g, h) {
       build_parents();
       build_M();
     }
@@ -164,7 +168,7 @@ void lazyforwardchecking_low_parent_degreeprune_ind(
             }
           }
         } else {
-          for (auto he : get_parent_edges(p)) {
+          for (auto he : get_parent_edges(x, p)) {
             // TODO maybe add edge_equiv() check for parent
             auto y = he.target;
             if (M_get(x, y) &&
@@ -190,15 +194,11 @@ void lazyforwardchecking_low_parent_degreeprune_ind(
       }
     }
 
-    auto get_parent_edges(parent_type p) {
+    auto get_parent_edges(IndexG x, parent_type p) {
       if constexpr (is_directed_v<H>) {
-        if (std::get<1>(p)) {
-          return h.out_edges(map[std::get<0>(p)]);
-        } else {
-          return h.in_edges(map[std::get<0>(p)]);
-        }
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
       } else {
-        return h.edges(map[std::get<0>(p)]);
+        return candidates.edges(x, map[std::get<0>(p)]);
       }
     }
 
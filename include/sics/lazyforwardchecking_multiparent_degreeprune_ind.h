@@ -0,0 +1,314 @@
+#ifndef SICS_LAZYFORWARDCHECKING_MULTIPARENT_DEGREEPRUNE_IND_H_
+#define SICS_LAZYFORWARDCHECKING_MULTIPARENT_DEGREEPRUNE_IND_H_
+
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <stack>
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "sorted_intersection.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// Like lazyforwardchecking_parent_degreeprune_ind, but the candidates of x
+// are the intersection of the neighbour lists of the images of all of its
+// mapped neighbours, not just those of one parent.  The lists are sorted
+// once up front and intersected starting from the shortest with the kernels
+// of sorted_intersection.h, so every candidate is already adjacent to all of
+// them.  Vertices of h whose list takes at least as much memory as a bitmap
+// over V(h) also get the bitmap, which the intersection probes instead of
+// walking the long list.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void lazyforwardchecking_multiparent_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+
+    // h_out[v] (and h_in[v] if directed): sorted neighbours of v, and their
+    // bitmaps if dense enough (empty otherwise)
+    std::vector<std::vector<IndexH>> h_out;
+    std::vector<std::vector<IndexH>> h_in;
+    std::vector<std::vector<std::uint64_t>> h_out_bitmaps;
+    std::vector<std::vector<std::uint64_t>> h_in_bitmaps;
+    void build_h_bitmaps(
+        std::vector<std::vector<IndexH>> const & lists,
+        std::vector<std::vector<std::uint64_t>> & bitmaps) {
+      bitmaps.resize(n);
+      for (IndexH v=0; v<n; ++v) {
+        if (lists[v].size() * sizeof(IndexH) * 8 >= n) {
+          bitmaps[v] = sorted_intersection_bitmap(lists[v].begin(), lists[v].end(), n);
+        }
+      }
+    }
+    void build_h_lists() {
+      h_out.resize(n);
+      for (IndexH v=0; v<n; ++v) {
+        for (auto he : edges_or_out_edges(h, v)) {
+          h_out[v].push_back(he.target);
+        }
+        std::sort(h_out[v].begin(), h_out[v].end());
+        h_out[v].erase(std::unique(h_out[v].begin(), h_out[v].end()), h_out[v].end());
+      }
+      build_h_bitmaps(h_out, h_out_bitmaps);
+      if constexpr (is_directed_v<H>) {
+        h_in.resize(n);
+        for (IndexH v=0; v<n; ++v) {
+          for (auto he : h.in_edges(v)) {
+            h_in[v].push_back(he.target);
+          }
+          std::sort(h_in[v].begin(), h_in[v].end());
+          h_in[v].erase(std::unique(h_in[v].begin(), h_in[v].end()), h_in[v].end());
+        }
+        build_h_bitmaps(h_in, h_in_bitmaps);
+      }
+    }
+
+    // parents[x]: the neighbours of x earlier in index_order_g; if directed,
+    // whether the candidates come from the out- (edge u -> x) or in-list of
+    // the image of u
+    using parent_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<IndexG, bool>,
+        std::tuple<IndexG>>;
+    std::vector<std::vector<parent_type>> parents;
+    void build_parents() {
+      std::vector<bool> done(m, false);
+      for (auto u : index_order_g) {
+        done[u] = true;
+        if constexpr (is_directed_v<G>) {
+          for (auto oe : g.out_edges(u)) {
+            auto i = oe.target;
+            if (!done[i]) {
+              parents[i].emplace_back(u, true);
+            }
+          }
+          for (auto ie : g.in_edges(u)) {
+            auto i = ie.target;
+            if (!done[i]) {
+              parents[i].emplace_back(u, false);
+            }
+          }
+        } else {
+          for (auto e : g.edges(u)) {
+            auto i = e.target;
+            if (!done[i]) {
+              parents[i].emplace_back(u);
+            }
+          }
+        }
+      }
+    }
+
+    std::vector<std::vector<IndexH>> candidates;
+    std::vector<IndexH> scratch;
+    // lists to intersect: neighbour list and bitmap (or nullptr)
+    std::vector<std::pair<std::vector<IndexH> const *, std::uint64_t const *>> lists;
+
+    std::vector<char> M;
+    bool M_get(IndexG u, IndexH v) {
+      return M[u*n + v];
+    }
+    void M_set(IndexG u, IndexH v) {
+      M[u*n + v] = true;
+    }
+    void M_unset(IndexG u, IndexH v) {
+      M[u*n + v] = false;
+    }
+    void build_M() {
+      for (IndexG u=0; u<m; ++u) {
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv(g, u, h, v) &&
+              degree_condition(g, u, h, v)) {
+            M_set(u, v);
+          }
+        }
+      }
+    }
+    std::vector<std::stack<std::pair<IndexG,IndexH>>> M_sts;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          level{0},
+          map(m, n),
+          parents(m),
+          candidates(m),
+          M(m * n, false),
+          M_sts(m) {
+      build_h_lists();
+      build_parents();
+      build_M();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+        bool proceed = true;
+
+        if (parents[x].empty()) {
+          for (IndexH y=0; y<n; ++y) {
+            if (M_get(x, y) &&
+                consistency(y)) {
+              map[x] = y;
+              ++level;
+              proceed = explore();
+              --level;
+              map[x] = n;
+              revert_M();
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        } else {
+          build_candidates();
+          for (auto y : candidates[level]) {
+            if (M_get(x, y) &&
+                consistency(y)) {
+              map[x] = y;
+              ++level;
+              proceed = explore();
+              --level;
+              map[x] = n;
+              revert_M();
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        }
+
+        return proceed;
+      }
+    }
+
+    std::pair<std::vector<IndexH> const *, std::uint64_t const *> get_parent_list(parent_type p) {
+      auto v = map[std::get<0>(p)];
+      if constexpr (is_directed_v<H>) {
+        if (!std::get<1>(p)) {
+          return {&h_in[v], h_in_bitmaps[v].empty() ? nullptr : h_in_bitmaps[v].data()};
+        }
+      }
+      return {&h_out[v], h_out_bitmaps[v].empty() ? nullptr : h_out_bitmaps[v].data()};
+    }
+
+    void build_candidates() {
+      auto x = index_order_g[level];
+
+      lists.clear();
+      for (auto p : parents[x]) {
+        lists.push_back(get_parent_list(p));
+      }
+      std::sort(lists.begin(), lists.end(), [](auto a, auto b) {
+        return a.first->size() < b.first->size();
+      });
+
+      auto & result = candidates[level];
+      result = *lists.front().first;
+      for (auto it=std::next(lists.cbegin()); it!=lists.cend() && !result.empty(); ++it) {
+        sorted_intersection(result, *it->first, scratch, it->second);
+        std::swap(result, scratch);
+      }
+    }
+
+    bool consistency(IndexH y) {
+      auto x = index_order_g[level];
+      for (IndexG i=0; i<level; ++i) {
+        auto u = index_order_g[i];
+        auto v = map[u];
+        if (v == y) {
+          M_unset(x, y);
+          M_sts[i].emplace(x, y);
+          return false;
+        }
+        auto x_out = g.edge(x, u);
+        if (x_out != h.edge(y, v) || (x_out && !edge_equiv(g, x, u, h, y, v))) {
+          M_unset(x, y);
+          M_sts[i].emplace(x, y);
+          return false;
+        }
+        if constexpr (is_directed_v<G>) {
+          auto x_in = g.edge(u, x);
+          if (x_in != h.edge(v, y) || (x_in && !edge_equiv(g, u, x, h, v, y))) {
+            M_unset(x, y);
+            M_sts[i].emplace(x, y);
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    void revert_M() {
+      while (!M_sts[level].empty()) {
+        IndexG u;
+        IndexH v;
+        std::tie(u, v) = M_sts[level].top();
+        M_sts[level].pop();
+        M_set(u, v);
+      }
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_LAZYFORWARDCHECKING_MULTIPARENT_DEGREEPRUNE_IND_H_
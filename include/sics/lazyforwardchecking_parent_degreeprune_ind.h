@@ -8,6 +8,8 @@
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
+#include "parent_candidates.h"
+#include "value_order.h"
 
 #include "stats.h"
 
@@ -19,14 +21,17 @@ template <
     typename Callback,
     typename IndexOrderG,
     typename VertexEquiv = default_vertex_label_equiv<G, H>,
-    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+    typename EdgeEquiv = default_edge_label_equiv<G, H>,
+    typename ValueOrder = natural_value_order>
 void lazyforwardchecking_parent_degreeprune_ind(
     G const & g,
     H const & h,
     Callback const & callback,
     IndexOrderG const & index_order_g,
     VertexEquiv const & vertex_equiv = VertexEquiv(),
-    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+    EdgeEquiv const & edge_equiv = EdgeEquiv(),
+    ValueOrder const & value_order = ValueOrder()) {
+  static_assert(!ValueOrder::uses_removals, "lazyforwardchecking_parent_degreeprune_ind has no future domains");
 
   using IndexG = typename G::index_type;
   using IndexH = typename H::index_type;
@@ -109,13 +114,19 @@ void lazyforwardchecking_parent_degreeprune_ind(
     }
     std::vector<std::stack<std::pair<IndexG,IndexH>>> M_sts;
 
+    parent_candidates<G, H, VertexEquiv> candidates;
+
+    typename ValueOrder::template ranker<G, H> value_rank;
+    std::vector<std::vector<IndexH>> ordered;
+
     explorer(
         G const & g,
         H const & h,
         Callback const & callback,
         IndexOrderG const & index_order_g,
         VertexEquiv const & vertex_equiv,
-        EdgeEquiv const & edge_equiv)
+        EdgeEquiv const & edge_equiv,
+        ValueOrder const & value_order)
         : g{g},
           h{h},
           callback{callback},
@@ -129,7 +140,10 @@ void lazyforwardchecking_parent_degreeprune_ind(
           map(m, n),
           parents(m),
           M(m * n, false),
-          M_sts(m) {
+          M_sts(m),
+          candidates(g, h),
+          value_rank(value_order, g, h),
+          ordered(m) {
       build_parents();
       build_M();
     }
@@ -143,33 +157,54 @@ void lazyforwardchecking_parent_degreeprune_ind(
         bool proceed = true;
 
         parent_type p = parents[x];
-        if (std::get<0>(p) == m) {
+        if constexpr (ValueOrder::is_ordered) {
+          // the candidates are all checked before the first is extended;
+          // the children only remove values for later levels, so the
+          // result is the same
+          auto & ys = ordered[level];
+          ys.clear();
+          if (std::get<0>(p) == m) {
+            for (IndexH y=0; y<n; ++y) {
+              if (M_get(x, y) &&
+                  consistency(y)) {
+                ys.push_back(y);
+              }
+            }
+          } else {
+            for (auto he : get_parent_edges(x, p)) {
+              auto y = he.target;
+              if (M_get(x, y) &&
+                  consistency(y)) {
+                ys.push_back(y);
+              }
+            }
+          }
+          order_values(value_rank, ys, [](IndexH) {
+            return 0;
+          });
+          for (auto y : ys) {
+            proceed = extend(x, y);
+            if (!proceed) {
+              break;
+            }
+          }
+        } else if (std::get<0>(p) == m) {
           for (IndexH y=0; y<n; ++y) {
             if (M_get(x, y) &&
                 consistency(y)) {
-              map[x] = y;
-              ++level;
-              proceed = explore();
-              --level;
-              map[x] = n;
-              revert_M();
+              proceed = extend(x, y);
               if (!proceed) {
                 break;
               }
             }
           }
         } else {
-          for (auto he : get_parent_edges(p)) {
+          for (auto he : get_parent_edges(x, p)) {
             // TODO maybe add edge_equiv() check for parent
             auto y = he.target;
             if (M_get(x, y) &&
                 consistency(y)) {
-              map[x] = y;
-              ++level;
-              proceed = explore();
-              --level;
-              map[x] = n;
-              revert_M();
+              proceed = extend(x, y);
               if (!proceed) {
                 break;
               }
@@ -181,15 +216,21 @@ void lazyforwardchecking_parent_degreeprune_ind(
       }
     }
 
-    auto get_parent_edges(parent_type p) {
+    bool extend(IndexG x, IndexH y) {
+      map[x] = y;
+      ++level;
+      bool proceed = explore();
+      --level;
+      map[x] = n;
+      revert_M();
+      return proceed;
+    }
+
+    auto get_parent_edges(IndexG x, parent_type p) {
       if constexpr (is_directed_v<H>) {
-        if (std::get<1>(p)) {
-          return h.out_edges(map[std::get<0>(p)]);
-        } else {
-          return h.in_edges(map[std::get<0>(p)]);
-        }
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
       } else {
-        return h.edges(map[std::get<0>(p)]);
+        return candidates.edges(x, map[std::get<0>(p)]);
       }
     }
 
@@ -230,7 +271,7 @@ void lazyforwardchecking_parent_degreeprune_ind(
         M_set(u, v);
       }
     }
-  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv, value_order);
 
   e.explore();
 }
@@ -9,6 +9,7 @@
 #include "graph_traits.h"
 #include "label_equivalence.h"
 #include "consistency_utilities.h"
+#include "parent_candidates.h"
 
 #include "stats.h"
 
@@ -120,6 +121,8 @@ void lazyforwardchecking_parent_degreesequenceprune_ind(
     }
     std::vector<std::stack<std::pair<IndexG,IndexH>>> M_sts;
 
+    parent_candidates<G, H, VertexEquiv> candidates;
+
     explorer(
         G const & g,
         H const & h,
@@ -140,7 +143,8 @@ void lazyforwardchecking_parent_degreesequenceprune_ind(
           map(m, n),
           parents(m),
           M(m * n, false),
-          M_sts(m) {
+          M_sts(m),
+          candidates(g, h) {
       build_parents();
       build_M();
     }
@@ -170,7 +174,7 @@ void lazyforwardchecking_parent_degreesequenceprune_ind(
             }
           }
         } else {
-          for (auto he : get_parent_edges(p)) {
+          for (auto he : get_parent_edges(x, p)) {
             // TODO maybe add edge_equiv() check for parent
             auto y = he.target;
             if (M_get(x, y) &&
@@ -192,15 +196,11 @@ void lazyforwardchecking_parent_degreesequenceprune_ind(
       }
     }
 
-    auto get_parent_edges(parent_type p) {
+    auto get_parent_edges(IndexG x, parent_type p) {
       if constexpr (is_directed_v<H>) {
-        if (std::get<1>(p)) {
-          return h.out_edges(map[std::get<0>(p)]);
-        } else {
-          return h.in_edges(map[std::get<0>(p)]);
-        }
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
       } else {
-        return h.edges(map[std::get<0>(p)]);
+        return candidates.edges(x, map[std::get<0>(p)]);
       }
     }
 
@@ -0,0 +1,288 @@
+#ifndef SICS_LAZYFORWARDCHECKING_PARENT_DYNAMICORDER_DEGREEPRUNE_IND_H_
+#define SICS_LAZYFORWARDCHECKING_PARENT_DYNAMICORDER_DEGREEPRUNE_IND_H_
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+#include <stack>
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "parent_candidates.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// Like lazyforwardchecking_parent_degreeprune_ind, but the next pattern
+// vertex is picked during the search.  For every unmapped vertex u, bound[u]
+// is an upper bound on its candidates: the size of its row of M, lowered to
+// the degree of the image of each mapped neighbour.  The mapped neighbour
+// whose image has the smallest degree is u's parent, whose neighbour list
+// then generates the candidates, even if the row of M is smaller.  The vertex with the smallest bound is chosen next (ties broken
+// by more mapped neighbours, then larger degree), so a node costs O(m) plus
+// the degree of the chosen vertex on top of the lazy checks.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void lazyforwardchecking_parent_dynamicorder_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    IndexG level;
+
+    std::vector<IndexG> index_order_g;
+
+    std::vector<IndexH> map;
+
+    using parent_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<IndexG, bool>,
+        std::tuple<IndexG>>;
+    std::vector<parent_type> parents;
+    // parent_degree[u]: the degree of the image of parents[u], or n
+    std::vector<IndexH> parent_degree;
+    std::vector<IndexH> bound;
+    std::vector<IndexG> mapped_neighbours;
+    std::vector<std::stack<std::tuple<IndexG, IndexH, parent_type, IndexH>>> bound_sts;
+
+    std::vector<char> M;
+    bool M_get(IndexG u, IndexH v) {
+      return M[u*n + v];
+    }
+    void M_set(IndexG u, IndexH v) {
+      M[u*n + v] = true;
+    }
+    void M_unset(IndexG u, IndexH v) {
+      M[u*n + v] = false;
+    }
+    void build_M() {
+      for (IndexG u=0; u<m; ++u) {
+        std::get<0>(parents[u]) = m;
+        bound[u] = 0;
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv(g, u, h, v) &&
+              degree_condition(g, u, h, v)) {
+            M_set(u, v);
+            ++bound[u];
+          }
+        }
+      }
+    }
+    std::vector<std::stack<std::pair<IndexG,IndexH>>> M_sts;
+
+    parent_candidates<G, H, VertexEquiv> candidates;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          level{0},
+          index_order_g(m, m),
+          map(m, n),
+          parents(m),
+          parent_degree(m, n),
+          bound(m),
+          mapped_neighbours(m, 0),
+          bound_sts(m),
+          M(m * n, false),
+          M_sts(m),
+          candidates(g, h) {
+      build_M();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = select();
+        index_order_g[level] = x;
+        bool proceed = true;
+
+        parent_type p = parents[x];
+        if (std::get<0>(p) == m) {
+          for (IndexH y=0; y<n; ++y) {
+            if (M_get(x, y) &&
+                consistency(y)) {
+              proceed = assign_and_explore(x, y);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        } else {
+          for (auto he : get_parent_edges(x, p)) {
+            auto y = he.target;
+            if (M_get(x, y) &&
+                consistency(y)) {
+              proceed = assign_and_explore(x, y);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        }
+
+        index_order_g[level] = m;
+        return proceed;
+      }
+    }
+
+    IndexG select() {
+      IndexG x = m;
+      for (IndexG u=0; u<m; ++u) {
+        if (map[u] != n) {
+          continue;
+        }
+        if (x == m ||
+            bound[u] < bound[x] ||
+            (bound[u] == bound[x] &&
+             std::forward_as_tuple(mapped_neighbours[u], g.degree(u)) >
+             std::forward_as_tuple(mapped_neighbours[x], g.degree(x)))) {
+          x = u;
+        }
+      }
+      return x;
+    }
+
+    bool assign_and_explore(IndexG x, IndexH y) {
+      map[x] = y;
+      for (auto oe : edges_or_out_edges(g, x)) {
+        if constexpr (is_directed_v<H>) {
+          tighten_bound(oe.target, h.out_degree(y), {x, true});
+        } else {
+          tighten_bound(oe.target, h.degree(y), {x});
+        }
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto ie : g.in_edges(x)) {
+          tighten_bound(ie.target, h.in_degree(y), {x, false});
+        }
+      }
+
+      ++level;
+      bool proceed = explore();
+      --level;
+
+      for (auto oe : edges_or_out_edges(g, x)) {
+        --mapped_neighbours[oe.target];
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto ie : g.in_edges(x)) {
+          --mapped_neighbours[ie.target];
+        }
+      }
+      revert_bound();
+      map[x] = n;
+      revert_M();
+      return proceed;
+    }
+
+    void tighten_bound(IndexG u, IndexH d, parent_type p) {
+      ++mapped_neighbours[u];
+      if (map[u] == n && d < parent_degree[u]) {
+        bound_sts[level].emplace(u, bound[u], parents[u], parent_degree[u]);
+        bound[u] = std::min(bound[u], d);
+        parents[u] = p;
+        parent_degree[u] = d;
+      }
+    }
+
+    auto get_parent_edges(IndexG x, parent_type p) {
+      if constexpr (is_directed_v<H>) {
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
+      } else {
+        return candidates.edges(x, map[std::get<0>(p)]);
+      }
+    }
+
+    bool consistency(IndexH y) {
+      auto x = index_order_g[level];
+      for (IndexG i=0; i<level; ++i) {
+        auto u = index_order_g[i];
+        auto v = map[u];
+        if (v == y) {
+          M_unset(x, y);
+          M_sts[i].emplace(x, y);
+          return false;
+        }
+        auto x_out = g.edge(x, u);
+        if (x_out != h.edge(y, v) || (x_out && !edge_equiv(g, x, u, h, y, v))) {
+          M_unset(x, y);
+          M_sts[i].emplace(x, y);
+          return false;
+        }
+        if constexpr (is_directed_v<G>) {
+          auto x_in = g.edge(u, x);
+          if (x_in != h.edge(v, y) || (x_in && !edge_equiv(g, u, x, h, v, y))) {
+            M_unset(x, y);
+            M_sts[i].emplace(x, y);
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    void revert_bound() {
+      while (!bound_sts[level].empty()) {
+        auto [u, b, p, d] = bound_sts[level].top();
+        bound_sts[level].pop();
+        bound[u] = b;
+        parents[u] = p;
+        parent_degree[u] = d;
+      }
+    }
+
+    void revert_M() {
+      while (!M_sts[level].empty()) {
+        IndexG u;
+        IndexH v;
+        std::tie(u, v) = M_sts[level].top();
+        M_sts[level].pop();
+        M_set(u, v);
+      }
+    }
+  } e(g, h, callback, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_LAZYFORWARDCHECKING_PARENT_DYNAMICORDER_DEGREEPRUNE_IND_H_
@@ -0,0 +1,258 @@
+#ifndef SICS_LEAPFROGTRIEJOIN_DEGREEPRUNE_IND_H_
+#define SICS_LEAPFROGTRIEJOIN_DEGREEPRUNE_IND_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "sorted_intersection.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// A worst-case optimal join (Leapfrog Triejoin, or Generic Join) over the
+// adjacency of h.
+//
+// Every vertex x of g is a variable with a unary relation, its domain: the
+// sorted vertices of h that pass vertex_equiv and degree_condition.  Every
+// edge u -> x of g is the binary relation of the edges of h, stored as
+// sorted CSR out- and in-lists.  Variables are bound in index_order_g.  The
+// values of x are the leapfrog_intersection of the lists of the images of
+// its earlier neighbours (its domain if it has none), enumerated lazily.
+// Probing the domain as a table is cheaper than joining it, since it is
+// usually much longer than the lists.  A clique or
+// cycle thus costs what the join bound allows instead of one edge() check
+// per candidate pair.  Edge labels, the directions that must be missing
+// between earlier neighbours, and, for an induced embedding, the non-edges
+// to the other earlier vertices are applied as a post-filter.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void leapfrogtriejoin_degreeprune_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+    std::vector<IndexG> inv;
+
+    // sorted CSR adjacency of h: out-lists (all lists if undirected) and
+    // in-lists
+    std::vector<std::size_t> h_out_offsets;
+    std::vector<IndexH> h_out_targets;
+    std::vector<std::size_t> h_in_offsets;
+    std::vector<IndexH> h_in_targets;
+    void build_csr(
+        std::vector<std::size_t> & offsets,
+        std::vector<IndexH> & targets,
+        bool in) {
+      offsets.push_back(0);
+      for (IndexH v=0; v<n; ++v) {
+        auto first = targets.size();
+        if constexpr (is_directed_v<H>) {
+          if (in) {
+            for (auto ie : h.in_edges(v)) {
+              targets.push_back(ie.target);
+            }
+          }
+        }
+        if (!in) {
+          for (auto oe : edges_or_out_edges(h, v)) {
+            targets.push_back(oe.target);
+          }
+        }
+        std::sort(std::next(targets.begin(), first), targets.end());
+        targets.erase(std::unique(std::next(targets.begin(), first), targets.end()), targets.end());
+        offsets.push_back(targets.size());
+      }
+    }
+
+    // domains[x]: the sorted vertices of h x may be mapped to on its own,
+    // and the same as a table for the variables the domain is not joined for
+    std::vector<std::vector<IndexH>> domains;
+    std::vector<char> M;
+    bool M_get(IndexG u, IndexH v) {
+      return M[u*n + v];
+    }
+    void build_domains() {
+      for (IndexG u=0; u<m; ++u) {
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv(g, u, h, v) && degree_condition(g, u, h, v)) {
+            domains[u].push_back(v);
+            M[u*n + v] = true;
+          }
+        }
+      }
+    }
+
+    // per level l, for x = index_order_g[l]: the earlier vertices u with
+    // edges between them, whether u -> x and x -> u, and the earlier
+    // vertices with no edge
+    std::vector<std::vector<std::tuple<IndexG, bool, bool>>> joined;
+    std::vector<std::vector<IndexG>> non_neighbours;
+    void build_levels() {
+      for (IndexG l=0; l<m; ++l) {
+        auto x = index_order_g[l];
+        for (IndexG i=0; i<l; ++i) {
+          auto u = index_order_g[i];
+          bool in = g.edge(u, x);
+          bool out = g.edge(x, u);
+          if (in || out) {
+            joined[l].emplace_back(u, in, out);
+          } else {
+            non_neighbours[l].push_back(u);
+          }
+        }
+      }
+    }
+
+    std::vector<std::vector<std::pair<IndexH const *, IndexH const *>>> ranges;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          level{0},
+          map(m, n),
+          inv(n, m),
+          domains(m),
+          M(m * n, false),
+          joined(m),
+          non_neighbours(m),
+          ranges(m) {
+      build_csr(h_out_offsets, h_out_targets, false);
+      if constexpr (is_directed_v<H>) {
+        build_csr(h_in_offsets, h_in_targets, true);
+      }
+      build_domains();
+      build_levels();
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+
+        auto & r = ranges[level];
+        r.clear();
+        if (joined[level].empty()) {
+          r.emplace_back(domains[x].data(), domains[x].data() + domains[x].size());
+        }
+        for (auto [u, in, out] : joined[level]) {
+          auto v = map[u];
+          if (in) {
+            r.emplace_back(h_out_targets.data() + h_out_offsets[v], h_out_targets.data() + h_out_offsets[v + 1]);
+          }
+          if constexpr (is_directed_v<H>) {
+            if (out) {
+              r.emplace_back(h_in_targets.data() + h_in_offsets[v], h_in_targets.data() + h_in_offsets[v + 1]);
+            }
+          }
+        }
+
+        return leapfrog_intersection(r, [this, x](IndexH y) {
+          if (!filter(x, y)) {
+            return true;
+          }
+          map[x] = y;
+          inv[y] = x;
+          ++level;
+          bool proceed = explore();
+          --level;
+          inv[y] = m;
+          map[x] = n;
+          return proceed;
+        });
+      }
+    }
+
+    // the checks the join leaves out
+    bool filter(IndexG x, IndexH y) {
+      if (inv[y] != m || !M_get(x, y)) {
+        return false;
+      }
+      for (auto [u, in, out] : joined[level]) {
+        auto v = map[u];
+        if constexpr (is_directed_v<G>) {
+          if ((in && !edge_equiv(g, u, x, h, v, y)) ||
+              (out && !edge_equiv(g, x, u, h, y, v)) ||
+              (!in && h.edge(v, y)) ||
+              (!out && h.edge(y, v))) {
+            return false;
+          }
+        } else {
+          if (!edge_equiv(g, u, x, h, v, y)) {
+            return false;
+          }
+        }
+      }
+      for (auto u : non_neighbours[level]) {
+        auto v = map[u];
+        if (h.edge(y, v)) {
+          return false;
+        }
+        if constexpr (is_directed_v<H>) {
+          if (h.edge(v, y)) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_LEAPFROGTRIEJOIN_DEGREEPRUNE_IND_H_
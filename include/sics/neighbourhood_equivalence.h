@@ -0,0 +1,132 @@
+#ifndef SICS_NEIGHBOURHOOD_EQUIVALENCE_H_
+#define SICS_NEIGHBOURHOOD_EQUIVALENCE_H_
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+
+namespace sics {
+
+// Neighbourhood equivalence classes (NEC, as in TurboISO) of the vertices
+// of g: u0 and u1 are equivalent if they have no self-loops, the same out-
+// and in-neighbours, the same edge labels to them, and vertex_equiv holds
+// for u0 and v exactly when it holds for u1 and v, for every vertex v of h.
+// Equivalent vertices are pairwise non-adjacent, and any permutation of a
+// class is an automorphism of g that preserves the equivalences, so in
+// every embedding the images of a class can be permuted freely.
+//
+// With a custom EdgeEquiv, which may depend on the vertices and not just on
+// the labels, every vertex is its own class.  Each class is sorted and the
+// classes are sorted by their first vertex.
+template <
+    typename G,
+    typename H,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+std::vector<std::vector<typename G::index_type>> neighbourhood_equivalence_classes(
+    G const & g,
+    H const & h,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    [[maybe_unused]] EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  auto m = g.num_vertices();
+  auto n = h.num_vertices();
+  vertex_equiv_helper<VertexEquiv> vertex_equiv_h(vertex_equiv);
+
+  auto sorted_targets = [](auto const & edges) {
+    std::vector<IndexG> targets;
+    for (auto he : edges) {
+      targets.push_back(he.target);
+    }
+    std::sort(targets.begin(), targets.end());
+    return targets;
+  };
+
+  auto equivalent = [&](IndexG u0, IndexG u1) {
+    if constexpr (is_vertex_labelled_v<G>) {
+      if constexpr (std::is_same_v<VertexEquiv, default_vertex_label_equiv<G, H>>) {
+        if (!(g.get_vertex_label(u0) == g.get_vertex_label(u1))) {
+          return false;
+        }
+      } else {
+        for (IndexH v=0; v<n; ++v) {
+          if (vertex_equiv_h(g, u0, h, v) != vertex_equiv_h(g, u1, h, v)) {
+            return false;
+          }
+        }
+      }
+    } else if constexpr (!std::is_same_v<VertexEquiv, default_vertex_label_equiv<G, H>>) {
+      for (IndexH v=0; v<n; ++v) {
+        if (vertex_equiv_h(g, u0, h, v) != vertex_equiv_h(g, u1, h, v)) {
+          return false;
+        }
+      }
+    }
+    if constexpr (is_edge_labelled_v<G>) {
+      for (auto oe : edges_or_out_edges(g, u0)) {
+        if (!(g.get_edge_label(u0, oe.target) == g.get_edge_label(u1, oe.target))) {
+          return false;
+        }
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto ie : g.in_edges(u0)) {
+          if (!(g.get_edge_label(ie.target, u0) == g.get_edge_label(ie.target, u1))) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  };
+
+  std::vector<std::vector<IndexG>> classes;
+  if constexpr (!std::is_same_v<EdgeEquiv, default_edge_label_equiv<G, H>>) {
+    for (IndexG u=0; u<m; ++u) {
+      classes.push_back({u});
+    }
+    return classes;
+  }
+
+  // vertices with the same neighbours, then split by labels
+  std::map<std::pair<std::vector<IndexG>, std::vector<IndexG>>, std::vector<IndexG>> buckets;
+  for (IndexG u=0; u<m; ++u) {
+    if (g.edge(u, u)) {
+      classes.push_back({u});
+      continue;
+    }
+    std::pair<std::vector<IndexG>, std::vector<IndexG>> key;
+    key.first = sorted_targets(edges_or_out_edges(g, u));
+    if constexpr (is_directed_v<G>) {
+      key.second = sorted_targets(g.in_edges(u));
+    }
+    buckets[std::move(key)].push_back(u);
+  }
+  for (auto const & [key, bucket] : buckets) {
+    auto first = classes.size();
+    for (auto u : bucket) {
+      auto it = std::find_if(std::next(classes.begin(), first), classes.end(), [&](auto const & c) {
+        return equivalent(c.front(), u);
+      });
+      if (it != classes.end()) {
+        it->push_back(u);
+      } else {
+        classes.push_back({u});
+      }
+    }
+  }
+  std::sort(classes.begin(), classes.end());
+  return classes;
+}
+
+}  // namespace sics
+
+#endif  // SICS_NEIGHBOURHOOD_EQUIVALENCE_H_
@@ -0,0 +1,156 @@
+#ifndef SICS_NOGOOD_STORE_H_
+#define SICS_NOGOOD_STORE_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sics {
+
+// A bounded database of nogoods over literals (u, v), meaning pattern vertex
+// u is mapped to target vertex v.  A nogood is a set of literals that no
+// solution contains.
+//
+// Each nogood watches a single literal and is only looked at when that
+// literal is about to become true.  If another of its literals is false at
+// that point the watch moves there, otherwise the nogood is violated.  A
+// nogood can only become violated when its watched literal becomes true, so
+// no other bookkeeping is needed on assignment or backtracking.  Watch lists
+// exist only for literals that are watched, so memory is proportional to
+// the stored nogoods rather than to the number of possible literals.
+//
+// Every nogood has an activity, bumped whenever it prunes a value and decayed
+// by growing the bump increment.  When the store is full, the less active
+// half is evicted.
+template <typename IndexG, typename IndexH>
+class nogood_store {
+ public:
+  using literal_type = std::pair<IndexG, IndexH>;
+  using size_type = std::size_t;
+
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+ private:
+  struct nogood {
+    std::vector<literal_type> literals;
+    size_type watch;
+    double activity;
+  };
+
+  IndexH n;
+  size_type m_capacity;
+
+  std::vector<nogood> m_nogoods;
+  std::unordered_map<size_type, std::vector<size_type>> m_watches;
+
+  double m_increment;
+  double m_decay;
+
+  size_type literal_index(literal_type literal) const {
+    return size_type(literal.first) * n + literal.second;
+  }
+
+  void watch(size_type id) {
+    auto const & ng = m_nogoods[id];
+    m_watches[literal_index(ng.literals[ng.watch])].push_back(id);
+  }
+
+  void rescale() {
+    if (m_increment > 1e100) {
+      for (auto & ng : m_nogoods) {
+        ng.activity *= 1e-100;
+      }
+      m_increment *= 1e-100;
+    }
+  }
+
+  void bump(size_type id) {
+    m_nogoods[id].activity += m_increment;
+  }
+
+  void reduce() {
+    std::sort(m_nogoods.begin(), m_nogoods.end(), [](auto const & a, auto const & b) {
+      return a.activity > b.activity;
+    });
+    m_nogoods.resize(m_nogoods.size() / 2);
+    m_watches.clear();
+    for (size_type id=0; id<m_nogoods.size(); ++id) {
+      watch(id);
+    }
+  }
+
+ public:
+  nogood_store(IndexG /* m */, IndexH n, size_type capacity, double decay = 0.95)
+      : n{n},
+        m_capacity{std::max<size_type>(capacity, 1)},
+        m_increment{1},
+        m_decay{decay} {
+  }
+
+  size_type size() const {
+    return m_nogoods.size();
+  }
+
+  size_type capacity() const {
+    return m_capacity;
+  }
+
+  std::vector<literal_type> const & literals(size_type id) const {
+    return m_nogoods[id].literals;
+  }
+
+  // Adds the nogood [first, last), which must not be empty.
+  template <typename InputIt>
+  void add(InputIt first, InputIt last) {
+    if (m_nogoods.size() >= m_capacity) {
+      reduce();
+    }
+    m_nogoods.push_back({std::vector<literal_type>(first, last), 0, m_increment});
+    watch(m_nogoods.size() - 1);
+    m_increment /= m_decay;
+    rescale();
+  }
+
+  // Returns a nogood that assigning u to v would violate, given the current
+  // assignment map (map[w] is the image of w, or anything that matches no
+  // literal if w is unassigned), or npos if there is none.
+  template <typename Map>
+  size_type find_violated(IndexG u, IndexH v, Map const & map) {
+    auto it = m_watches.find(literal_index({u, v}));
+    if (it == m_watches.end()) {
+      return npos;
+    }
+    auto & ws = it->second;
+    for (size_type k=0; k<ws.size(); ) {
+      auto id = ws[k];
+      auto & ng = m_nogoods[id];
+      size_type false_literal = npos;
+      for (size_type i=0; i<ng.literals.size(); ++i) {
+        auto [w, z] = ng.literals[i];
+        if (w != u && map[w] != z) {
+          false_literal = i;
+          break;
+        }
+      }
+      if (false_literal == npos) {
+        bump(id);
+        return id;
+      }
+      ng.watch = false_literal;
+      watch(id);
+      ws[k] = ws.back();
+      ws.pop_back();
+    }
+    if (ws.empty()) {
+      m_watches.erase(literal_index({u, v}));
+    }
+    return npos;
+  }
+};
+
+}  // namespace sics
+
+#endif  // SICS_NOGOOD_STORE_H_
@@ -0,0 +1,170 @@
+#ifndef SICS_PARENT_CANDIDATES_H_
+#define SICS_PARENT_CANDIDATES_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+
+namespace sics {
+
+// The candidates of pattern vertex x among the neighbours of v, the image of
+// its parent, for the parent-driven degreeprune engines.  Only neighbours y
+// with h.degree(y) >= g.degree(x) can pass degree_condition, so when a list
+// is sorted by descending degree the range ends at that cut-off, found by
+// binary search.
+//
+// With vertex labels and the default label equivalence, the neighbours of
+// every vertex of h are sliced by label once up front, each slice sorted by
+// descending degree, and only the slice with the label of x is returned.
+// Otherwise the lists of h are used as they are, cut off if h is
+// degree-sorted.  Candidates still have to be checked by the engine; the
+// range only leaves out neighbours that cannot pass.
+template <typename G, typename H, typename VertexEquiv>
+class parent_candidates {
+ public:
+  using index_g_type = typename G::index_type;
+  using index_h_type = typename H::index_type;
+  using half_edge_type = typename H::half_edge_type;
+
+  static constexpr bool is_sliced =
+      is_vertex_labelled_v<G> &&
+      is_vertex_labelled_v<H> &&
+      std::is_same_v<VertexEquiv, default_vertex_label_equiv<G, H>>;
+  static constexpr bool is_cut = is_sliced || is_degree_sorted_v<H>;
+
+ private:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  G const & g;
+  H const & h;
+
+  // label id of every vertex of g (npos if the label is not in h)
+  std::vector<std::size_t> m_g_label_ids;
+
+  // neighbours of v sorted by label id, then descending degree, and the
+  // offset where the neighbours with each label id start
+  struct slices {
+    std::vector<half_edge_type> edges;
+    std::vector<std::pair<std::size_t, std::size_t>> starts;
+  };
+  std::vector<slices> m_out;
+  std::vector<slices> m_in;
+
+  template <typename Edges>
+  void build_slices(
+      slices & s,
+      Edges const & edges,
+      std::vector<std::size_t> const & h_label_ids) {
+    s.edges.assign(edges.begin(), edges.end());
+    std::sort(s.edges.begin(), s.edges.end(), [this, &h_label_ids](auto ha, auto hb) {
+      auto a = ha.target;
+      auto b = hb.target;
+      return std::make_tuple(h_label_ids[a], -std::ptrdiff_t(h.degree(a)), a) <
+             std::make_tuple(h_label_ids[b], -std::ptrdiff_t(h.degree(b)), b);
+    });
+    for (std::size_t i=0; i<s.edges.size(); ++i) {
+      auto id = h_label_ids[s.edges[i].target];
+      if (s.starts.empty() || s.starts.back().first != id) {
+        s.starts.emplace_back(id, i);
+      }
+    }
+  }
+
+  void build_slices() {
+    auto m = g.num_vertices();
+    auto n = h.num_vertices();
+
+    std::map<typename H::vertex_label_type, std::size_t> ids;
+    std::vector<std::size_t> h_label_ids(n);
+    for (index_h_type v=0; v<n; ++v) {
+      h_label_ids[v] = ids.emplace(h.get_vertex_label(v), ids.size()).first->second;
+    }
+    m_g_label_ids.resize(m);
+    for (index_g_type u=0; u<m; ++u) {
+      auto it = ids.find(g.get_vertex_label(u));
+      m_g_label_ids[u] = it != ids.end() ? it->second : npos;
+    }
+
+    m_out.resize(n);
+    for (index_h_type v=0; v<n; ++v) {
+      if constexpr (is_directed_v<H>) {
+        build_slices(m_out[v], h.out_edges(v), h_label_ids);
+      } else {
+        build_slices(m_out[v], h.edges(v), h_label_ids);
+      }
+    }
+    if constexpr (is_directed_v<H>) {
+      m_in.resize(n);
+      for (index_h_type v=0; v<n; ++v) {
+        build_slices(m_in[v], h.in_edges(v), h_label_ids);
+      }
+    }
+  }
+
+  auto slice(slices const & s, index_g_type x) const {
+    auto id = m_g_label_ids[x];
+    auto it = std::lower_bound(
+        s.starts.cbegin(),
+        s.starts.cend(),
+        std::make_pair(id, std::size_t{0}));
+    if (it == s.starts.cend() || it->first != id) {
+      return boost::make_iterator_range(s.edges.cend(), s.edges.cend());
+    }
+    auto first = std::next(s.edges.cbegin(), it->second);
+    auto last = std::next(it) != s.starts.cend() ? std::next(s.edges.cbegin(), std::next(it)->second) : s.edges.cend();
+    return boost::make_iterator_range(first, last);
+  }
+
+  template <typename Range>
+  Range cut(Range r, index_g_type x) const {
+    auto d = g.degree(x);
+    auto last = std::partition_point(r.begin(), r.end(), [this, d](auto const & he) {
+      return h.degree(he.target) >= d;
+    });
+    return Range(r.begin(), last);
+  }
+
+ public:
+  parent_candidates(G const & g, H const & h)
+      : g{g},
+        h{h} {
+    if constexpr (is_sliced) {
+      build_slices();
+    }
+  }
+
+  // Neighbours of v that x may be mapped to: out-neighbours (v -> y) if out,
+  // in-neighbours otherwise (directed h only).
+  auto edges(index_g_type x, index_h_type v, bool out = true) const {
+    if constexpr (is_sliced) {
+      return cut(slice(out ? m_out[v] : m_in[v], x), x);
+    } else {
+      auto r = [&] {
+        if constexpr (is_directed_v<H>) {
+          return out ? h.out_edges(v) : h.in_edges(v);
+        } else {
+          return h.edges(v);
+        }
+      }();
+      if constexpr (is_cut) {
+        return cut(r, x);
+      } else {
+        return r;
+      }
+    }
+  }
+};
+
+}  // namespace sics
+
+#endif  // SICS_PARENT_CANDIDATES_H_
@@ -0,0 +1,132 @@
+#ifndef SICS_VALUE_ORDER_H_
+#define SICS_VALUE_ORDER_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "graph_traits.h"
+
+namespace sics {
+
+// Value-ordering policies decide in which order an engine tries the
+// candidates of the current pattern vertex.  Engines take the policy object
+// as their last argument.  Each policy has a nested ranker<G, H>, built once
+// per search from the policy and the graphs, whose operator()(y, removals)
+// gives the key of candidate y; smaller keys are tried first and ties keep
+// index order.  removals() is supplied by the engine and returns the number
+// of values forward checking y would remove from the future domains; only
+// policies with uses_removals call it, and engines without future domains
+// reject those policies at compile time.
+//
+// Engines check is_ordered and keep iterating their candidate bitset or
+// list directly for natural_value_order.
+
+// Ascending target index.
+struct natural_value_order {
+  static constexpr bool is_ordered = false;
+  static constexpr bool uses_removals = false;
+
+  template <typename G, typename H>
+  struct ranker {
+    ranker(natural_value_order const &, G const &, H const &) {
+    }
+
+    template <typename Removals>
+    double operator()(typename H::index_type y, Removals const &) const {
+      return y;
+    }
+  };
+};
+
+// Target vertices of larger degree first.
+struct degree_value_order {
+  static constexpr bool is_ordered = true;
+  static constexpr bool uses_removals = false;
+
+  template <typename G, typename H>
+  struct ranker {
+    H const & h;
+
+    ranker(degree_value_order const &, G const &, H const & h)
+        : h{h} {
+    }
+
+    template <typename Removals>
+    double operator()(typename H::index_type y, Removals const &) const {
+      return -double(h.degree(y));
+    }
+  };
+};
+
+// Target vertices whose label is rarest in h first.  For unlabelled targets
+// this is the natural order.
+struct label_rarity_value_order {
+  static constexpr bool is_ordered = true;
+  static constexpr bool uses_removals = false;
+
+  template <typename G, typename H>
+  struct ranker {
+    std::vector<double> frequency;
+
+    ranker(label_rarity_value_order const &, G const &, H const & h)
+        : frequency(h.num_vertices(), 0) {
+      if constexpr (is_vertex_labelled_v<H>) {
+        std::map<typename H::vertex_label_type, double> counts;
+        for (typename H::index_type v=0; v<h.num_vertices(); ++v) {
+          ++counts[h.get_vertex_label(v)];
+        }
+        for (typename H::index_type v=0; v<h.num_vertices(); ++v) {
+          frequency[v] = counts[h.get_vertex_label(v)];
+        }
+      }
+    }
+
+    template <typename Removals>
+    double operator()(typename H::index_type y, Removals const &) const {
+      return frequency[y];
+    }
+  };
+};
+
+// Least constraining value: the candidates that remove the fewest values
+// from the future domains first.
+struct least_constraining_value_order {
+  static constexpr bool is_ordered = true;
+  static constexpr bool uses_removals = true;
+
+  template <typename G, typename H>
+  struct ranker {
+    ranker(least_constraining_value_order const &, G const &, H const &) {
+    }
+
+    template <typename Removals>
+    double operator()(typename H::index_type y, Removals const & removals) const {
+      return removals(y);
+    }
+  };
+};
+
+// Sorts candidates by rank(y, removals), keeping index order among ties.
+template <typename Ranker, typename Index, typename Removals>
+void order_values(
+    Ranker const & rank,
+    std::vector<Index> & candidates,
+    Removals const & removals) {
+  std::vector<std::pair<double, Index>> keyed;
+  keyed.reserve(candidates.size());
+  for (auto y : candidates) {
+    keyed.emplace_back(rank(y, removals), y);
+  }
+  std::sort(keyed.begin(), keyed.end());
+  for (std::size_t i=0; i<keyed.size(); ++i) {
+    candidates[i] = keyed[i].second;
+  }
+}
+
+}  // namespace sics
+
+#endif  // SICS_VALUE_ORDER_H_
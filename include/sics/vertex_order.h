@@ -6,9 +6,13 @@
 #include <tuple>
 #include <vector>
 #include <set>
+#include <utility>
 
 #include "graph_traits.h"
 #include "graph_utilities.h"
+#include "indexed_heap.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
 
 namespace sics {
 
@@ -22,6 +26,10 @@ std::vector<typename G::index_type> vertex_order_DEG(G const & g) {
   return order;
 }
 
+// Picks the vertex with the most already ordered neighbours (ties broken by
+// degree, then index).  The counts are bumped when a neighbour is placed and
+// the available vertices are kept in buckets by count, so this runs in
+// O((V+E) log V).
 template <typename G>
 std::vector<typename G::index_type> vertex_order_RDEG(G const & g) {
   using Index = typename G::index_type;
@@ -31,34 +39,52 @@ std::vector<typename G::index_type> vertex_order_RDEG(G const & g) {
   std::vector<Index> vertex_order(n);
 
   std::vector<bool> avail(n, true);
-  for (Index idx=0; idx<n; ++idx) {
-    auto bestn = n;
-    int bestv = -1;
-    for (Index i=0; i<n; ++i) {
-      if (avail[i]) {
-        auto i_out_edges = edges_or_out_edges(g, i);
-        int rdeg = std::count_if(std::begin(i_out_edges), std::end(i_out_edges), [&avail](auto oe) {
-          return !avail[oe.target];
-        });
-        if constexpr (is_directed_v<G>) {
-          auto i_in_edges = g.in_edges(i);
-          rdeg += std::count_if(std::begin(i_in_edges), std::end(i_in_edges), [&avail](auto ie) {
-            return !avail[ie.target];
-          });
-        }
+  std::vector<Index> rdeg(n, 0);
 
-        if (bestn == n || std::forward_as_tuple(rdeg, g.degree(i), i) > std::forward_as_tuple(bestv, g.degree(bestn), bestn)) {
-          bestn = i;
-          bestv = rdeg;
-        }
-      }
+  Index max_degree = 0;
+  for (Index i=0; i<n; ++i) {
+    max_degree = std::max(max_degree, g.degree(i));
+  }
+  std::vector<std::set<std::pair<Index, Index>>> buckets(max_degree + 1);
+  for (Index i=0; i<n; ++i) {
+    buckets[0].emplace(g.degree(i), i);
+  }
+  Index top = 0;
+
+  auto bump = [&](Index v) {
+    if (avail[v]) {
+      buckets[rdeg[v]].erase({g.degree(v), v});
+      ++rdeg[v];
+      buckets[rdeg[v]].emplace(g.degree(v), v);
+      top = std::max(top, rdeg[v]);
+    }
+  };
+
+  for (Index idx=0; idx<n; ++idx) {
+    while (buckets[top].empty()) {
+      --top;
     }
+    auto best = std::prev(buckets[top].end());
+    auto bestn = best->second;
+    buckets[top].erase(best);
     avail[bestn] = false;
     vertex_order[idx] = bestn;
+
+    for (auto oe : edges_or_out_edges(g, bestn)) {
+      bump(oe.target);
+    }
+    if constexpr (is_directed_v<G>) {
+      for (auto ie : g.in_edges(bestn)) {
+        bump(ie.target);
+      }
+    }
   }
   return vertex_order;
 }
 
+// The ranks are kept in an indexed max-heap and only the ranks of the
+// neighbours (and neighbours of new neighbours) of the chosen vertex are
+// updated, so this runs in O((V+E) log V).
 template <typename G>
 std::vector<typename G::index_type> vertex_order_GreatestConstraintFirst(G const & g) {
   using Index = typename G::index_type;
@@ -66,7 +92,6 @@ std::vector<typename G::index_type> vertex_order_GreatestConstraintFirst(G const
   auto n = g.num_vertices();
 
   std::vector<Index> vertex_order(n);
-  std::iota(std::begin(vertex_order), std::end(vertex_order), 0);
 
   enum struct Flag {
     vis,
@@ -82,49 +107,59 @@ std::vector<typename G::index_type> vertex_order_GreatestConstraintFirst(G const
     std::get<3>(ranks[i]) = i;
   }
 
+  auto ranks_less = [&ranks](auto u, auto v) {
+    return ranks[u] < ranks[v];
+  };
+  indexed_max_heap<Index, decltype(ranks_less)> heap(n, ranks_less);
+  for (Index i=0; i<n; ++i) {
+    heap.push(i);
+  }
+
   for (Index m=0; m<n; ++m) {
-    auto u_it = std::max_element(
-        std::next(std::begin(vertex_order), m),
-        std::end(vertex_order),
-        [&ranks](auto u, auto v) {
-          return ranks[u] < ranks[v];
-        });
-    Index u = *u_it;
+    Index u = heap.top();
+    heap.pop();
 
     if (flags[u] == Flag::unv) {
       for (auto oe : edges_or_out_edges(g, u)) {
         --std::get<2>(ranks[oe.target]);
+        heap.update(oe.target);
       }
       if constexpr (is_directed_v<G>) {
         for (auto ie : g.in_edges(u)) {
           --std::get<2>(ranks[ie.target]);
+          heap.update(ie.target);
         }
       }
     } else if (flags[u] == Flag::neigh) {
       for (auto oe : edges_or_out_edges(g, u)) {
         --std::get<1>(ranks[oe.target]);
+        heap.update(oe.target);
       }
       if constexpr (is_directed_v<G>) {
         for (auto ie : g.in_edges(u)) {
           --std::get<1>(ranks[ie.target]);
+          heap.update(ie.target);
         }
       }
     }
 
-    std::swap(vertex_order[m], *u_it);
+    vertex_order[m] = u;
     flags[u] = Flag::vis;
 
     for (auto oe : edges_or_out_edges(g, u)) {
       auto v = oe.target;
       ++std::get<0>(ranks[v]);
+      heap.update(v);
       if (flags[v] == Flag::unv) {
         flags[v] = Flag::neigh;
         for (auto v_oe : edges_or_out_edges(g, v)) {
           ++std::get<1>(ranks[v_oe.target]);
+          heap.update(v_oe.target);
         }
         if constexpr (is_directed_v<G>) {
           for (auto v_ie : g.in_edges(v)) {
             ++std::get<1>(ranks[v_ie.target]);
+            heap.update(v_ie.target);
           }
         }
       }
@@ -133,16 +168,211 @@ std::vector<typename G::index_type> vertex_order_GreatestConstraintFirst(G const
       for (auto ie : g.in_edges(u)) {
         auto v = ie.target;
         ++std::get<0>(ranks[v]);
+        heap.update(v);
         if (flags[v] == Flag::unv) {
           flags[v] = Flag::neigh;
           for (auto v_oe : g.out_edges(v)) {
             ++std::get<1>(ranks[v_oe.target]);
+            heap.update(v_oe.target);
           }
           for (auto v_ie : g.in_edges(v)) {
             ++std::get<1>(ranks[v_ie.target]);
+            heap.update(v_ie.target);
+          }
+        }
+      }
+    }
+  }
+  return vertex_order;
+}
+
+// Orders g for matching into h, in the style of the RI and GraphQL
+// orderings.  Each pattern vertex u gets its candidate set C(u), the target
+// vertices passing the label and degree filters, and each pattern edge (u,w)
+// the fraction of pairs in C(u) x C(w) joined by a target edge.  Starting from
+// the vertex with the fewest candidates, the next vertex is the one that
+// minimises the estimated number of partial matches, |C(w)| times the edge
+// selectivities to the already ordered vertices.  Ties are broken by the
+// number of ordered neighbours, then degree, then the lower index.
+template <
+    typename G,
+    typename H,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>>
+std::vector<typename G::index_type> vertex_order_CandidateCost(
+    G const & g,
+    H const & h,
+    VertexEquiv const & vertex_equiv = VertexEquiv()) {
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  vertex_equiv_helper<VertexEquiv> vertex_equiv_h{vertex_equiv};
+
+  auto m = g.num_vertices();
+  auto n = h.num_vertices();
+
+  std::vector<std::vector<IndexH>> C(m);
+  std::vector<std::vector<bool>> in_C(m, std::vector<bool>(n, false));
+  for (IndexG u=0; u<m; ++u) {
+    for (IndexH v=0; v<n; ++v) {
+      if (vertex_equiv_h(g, u, h, v) && degree_condition(g, u, h, v)) {
+        C[u].push_back(v);
+        in_C[u][v] = true;
+      }
+    }
+  }
+
+  // sel[u*m+w]: estimated probability that a pair in C(u) x C(w) is an edge
+  // u -> w of h.
+  std::vector<double> sel(m * m, 1.0);
+  for (IndexG u=0; u<m; ++u) {
+    for (auto oe : edges_or_out_edges(g, u)) {
+      auto w = oe.target;
+      if (w == u || C[u].empty() || C[w].empty()) {
+        continue;
+      }
+      double joined = 0;
+      for (auto v : C[u]) {
+        for (auto he : edges_or_out_edges(h, v)) {
+          if (in_C[w][he.target]) {
+            ++joined;
           }
         }
       }
+      sel[u*m+w] = joined / (double(C[u].size()) * double(C[w].size()));
+    }
+  }
+
+  std::vector<IndexG> vertex_order;
+  vertex_order.reserve(m);
+
+  std::vector<bool> ordered(m, false);
+  std::vector<IndexG> ordered_neighbours(m, 0);
+
+  auto cost = [&](IndexG w) {
+    double result = C[w].size();
+    for (auto oe : edges_or_out_edges(g, w)) {
+      if (ordered[oe.target]) {
+        result *= sel[w*m+oe.target];
+      }
+    }
+    if constexpr (is_directed_v<G>) {
+      for (auto ie : g.in_edges(w)) {
+        if (ordered[ie.target]) {
+          result *= sel[ie.target*m+w];
+        }
+      }
+    }
+    return result;
+  };
+
+  for (IndexG idx=0; idx<m; ++idx) {
+    bool connected = false;
+    for (IndexG w=0; w<m; ++w) {
+      if (!ordered[w] && ordered_neighbours[w] > 0) {
+        connected = true;
+        break;
+      }
+    }
+
+    IndexG best = m;
+    double best_cost = 0;
+    for (IndexG w=0; w<m; ++w) {
+      if (ordered[w] || (connected && ordered_neighbours[w] == 0)) {
+        continue;
+      }
+      auto w_cost = cost(w);
+      if (best == m ||
+          w_cost < best_cost ||
+          (w_cost == best_cost &&
+           std::forward_as_tuple(ordered_neighbours[w], g.degree(w)) >
+           std::forward_as_tuple(ordered_neighbours[best], g.degree(best)))) {
+        best = w;
+        best_cost = w_cost;
+      }
+    }
+
+    ordered[best] = true;
+    vertex_order.push_back(best);
+
+    for (auto oe : edges_or_out_edges(g, best)) {
+      ++ordered_neighbours[oe.target];
+    }
+    if constexpr (is_directed_v<G>) {
+      for (auto ie : g.in_edges(best)) {
+        ++ordered_neighbours[ie.target];
+      }
+    }
+  }
+  return vertex_order;
+}
+
+// The ordering of VF3.  Each pattern vertex u gets the probability P(u) that
+// a random target vertex is compatible with it, the fraction of h passing
+// the label filter times the fraction passing the degree filter.  The next
+// vertex is the one with the most already ordered neighbours, ties broken by
+// the lower probability, then the larger degree, then the lower index.
+template <
+    typename G,
+    typename H,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>>
+std::vector<typename G::index_type> vertex_order_VF3(
+    G const & g,
+    H const & h,
+    VertexEquiv const & vertex_equiv = VertexEquiv()) {
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  vertex_equiv_helper<VertexEquiv> vertex_equiv_h{vertex_equiv};
+
+  auto m = g.num_vertices();
+  auto n = h.num_vertices();
+
+  std::vector<double> probability(m, 0);
+  if (n > 0) {
+    for (IndexG u=0; u<m; ++u) {
+      double label = 0;
+      double degree = 0;
+      for (IndexH v=0; v<n; ++v) {
+        if (vertex_equiv_h(g, u, h, v)) {
+          ++label;
+        }
+        if (degree_condition(g, u, h, v)) {
+          ++degree;
+        }
+      }
+      probability[u] = (label / n) * (degree / n);
+    }
+  }
+
+  std::vector<IndexG> vertex_order;
+  vertex_order.reserve(m);
+
+  std::vector<bool> ordered(m, false);
+  std::vector<IndexG> ordered_neighbours(m, 0);
+
+  for (IndexG idx=0; idx<m; ++idx) {
+    IndexG best = m;
+    for (IndexG w=0; w<m; ++w) {
+      if (ordered[w]) {
+        continue;
+      }
+      if (best == m ||
+          std::make_tuple(ordered_neighbours[w], -probability[w], g.degree(w)) >
+          std::make_tuple(ordered_neighbours[best], -probability[best], g.degree(best))) {
+        best = w;
+      }
+    }
+
+    ordered[best] = true;
+    vertex_order.push_back(best);
+
+    for (auto oe : edges_or_out_edges(g, best)) {
+      ++ordered_neighbours[oe.target];
+    }
+    if constexpr (is_directed_v<G>) {
+      for (auto ie : g.in_edges(best)) {
+        ++ordered_neighbours[ie.target];
+      }
     }
   }
   return vertex_order;
@@ -0,0 +1,294 @@
+#ifndef SICS_VERTEX_ORDER_OPTIMIZER_H_
+#define SICS_VERTEX_ORDER_OPTIMIZER_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "graph_traits.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "vertex_order.h"
+
+namespace sics {
+
+// Measures the search tree of a fixed order the way the parent engines walk
+// it: candidates for a vertex come from the neighbours of its parent's image
+// (or all of h if it has none) and are checked for labels, degrees,
+// injectivity and induced adjacency to every earlier vertex.
+template <
+    typename G,
+    typename H,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+class order_cost_explorer {
+ public:
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+ private:
+  G const & g;
+  H const & h;
+
+  vertex_equiv_helper<VertexEquiv> vertex_equiv;
+  edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+  IndexG m;
+  IndexH n;
+
+  std::vector<IndexG> order;
+
+  using parent_type = std::conditional_t<
+      is_directed_v<H>,
+      std::tuple<IndexG, bool>,
+      std::tuple<IndexG>>;
+  std::vector<parent_type> parents;
+  void build_parents() {
+    parents.assign(m, parent_type{});
+    for (IndexG u=0; u<m; ++u) {
+      std::get<0>(parents[u]) = m;
+    }
+    std::vector<bool> done(m, false);
+    for (auto u : order) {
+      done[u] = true;
+      for (auto oe : edges_or_out_edges(g, u)) {
+        auto i = oe.target;
+        if (std::get<0>(parents[i]) == m && !done[i]) {
+          if constexpr (is_directed_v<H>) {
+            parents[i] = {u, true};
+          } else {
+            parents[i] = {u};
+          }
+        }
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto ie : g.in_edges(u)) {
+          auto i = ie.target;
+          if (std::get<0>(parents[i]) == m && !done[i]) {
+            parents[i] = {u, false};
+          }
+        }
+      }
+    }
+  }
+
+  IndexG level;
+
+  std::vector<IndexH> map;
+  std::vector<IndexG> inv;
+
+  std::size_t nodes;
+  std::size_t node_budget;
+
+  bool consistency(IndexG x, IndexH y) {
+    if (inv[y] != m ||
+        !vertex_equiv(g, x, h, y) ||
+        !degree_condition(g, x, h, y)) {
+      return false;
+    }
+    for (IndexG i=0; i<level; ++i) {
+      auto u = order[i];
+      auto v = map[u];
+      auto x_out = g.edge(x, u);
+      if (x_out != h.edge(y, v) || (x_out && !edge_equiv(g, x, u, h, y, v))) {
+        return false;
+      }
+      if constexpr (is_directed_v<G>) {
+        auto x_in = g.edge(u, x);
+        if (x_in != h.edge(v, y) || (x_in && !edge_equiv(g, u, x, h, v, y))) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Calls f(y) for every consistent candidate y of the vertex at level;
+  // stops as soon as f returns false.
+  template <typename F>
+  bool for_each_candidate(F f) {
+    auto x = order[level];
+    auto p = parents[x];
+    if (std::get<0>(p) == m) {
+      for (IndexH y=0; y<n; ++y) {
+        if (consistency(x, y) && !f(y)) {
+          return false;
+        }
+      }
+    } else {
+      auto pv = map[std::get<0>(p)];
+      auto visit = [&](auto const & edges) {
+        for (auto he : edges) {
+          if (consistency(x, he.target) && !f(he.target)) {
+            return false;
+          }
+        }
+        return true;
+      };
+      if constexpr (is_directed_v<H>) {
+        return std::get<1>(p) ? visit(h.out_edges(pv)) : visit(h.in_edges(pv));
+      } else {
+        return visit(h.edges(pv));
+      }
+    }
+    return true;
+  }
+
+  bool explore() {
+    if (++nodes > node_budget) {
+      return false;
+    }
+    if (level == m) {
+      return true;
+    }
+    auto x = order[level];
+    return for_each_candidate([this, x](IndexH y) {
+      map[x] = y;
+      inv[y] = x;
+      ++level;
+      bool proceed = explore();
+      --level;
+      inv[y] = m;
+      map[x] = n;
+      return proceed;
+    });
+  }
+
+ public:
+  order_cost_explorer(
+      G const & g,
+      H const & h,
+      VertexEquiv const & vertex_equiv,
+      EdgeEquiv const & edge_equiv)
+      : g{g},
+        h{h},
+        vertex_equiv{vertex_equiv},
+        edge_equiv{edge_equiv},
+        m{g.num_vertices()},
+        n{h.num_vertices()},
+        level{0},
+        map(m, n),
+        inv(n, m),
+        nodes{0},
+        node_budget{0} {
+  }
+
+  template <typename IndexOrderG>
+  void set_order(IndexOrderG const & index_order_g) {
+    order.assign(std::cbegin(index_order_g), std::cend(index_order_g));
+    build_parents();
+  }
+
+  // Number of nodes of the whole search tree, or budget+1 if it has more
+  // than budget nodes.
+  std::size_t count_nodes(std::size_t budget) {
+    nodes = 0;
+    node_budget = budget;
+    explore();
+    return std::min(nodes, budget + 1);
+  }
+
+  // Knuth's estimate of the size of the search tree from one random probe:
+  // the sum over the levels of the product of the branching factors seen so
+  // far.
+  template <typename URBG>
+  double probe(URBG & rng) {
+    double estimate = 1;
+    double width = 1;
+    std::vector<IndexH> candidates;
+    std::vector<IndexG> path;
+    for (level=0; level<m; ++level) {
+      candidates.clear();
+      for_each_candidate([&candidates](IndexH y) {
+        candidates.push_back(y);
+        return true;
+      });
+      if (candidates.empty()) {
+        break;
+      }
+      width *= candidates.size();
+      estimate += width;
+      auto x = order[level];
+      auto y = candidates[std::uniform_int_distribution<std::size_t>(0, candidates.size()-1)(rng)];
+      map[x] = y;
+      inv[y] = x;
+      path.push_back(x);
+    }
+    for (auto x : path) {
+      inv[map[x]] = m;
+      map[x] = n;
+    }
+    level = 0;
+    return estimate;
+  }
+};
+
+// Picks the cheapest of several candidate orders for matching g into h: the
+// pattern-only orders, vertex_order_CandidateCost and num_perturbations
+// random perturbations of it.  Each is first searched exhaustively with at
+// most node_budget nodes; orders that finish are ranked by their exact node
+// count, the others by the mean of num_probes random-probe estimates (which
+// are never below node_budget).
+template <
+    typename G,
+    typename H,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+std::vector<typename G::index_type> vertex_order_Optimized(
+    G const & g,
+    H const & h,
+    std::size_t node_budget = 10000,
+    std::size_t num_probes = 64,
+    std::size_t num_perturbations = 4,
+    unsigned seed = 0,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+  using IndexG = typename G::index_type;
+
+  auto m = g.num_vertices();
+
+  std::vector<std::vector<IndexG>> orders;
+  orders.push_back(vertex_order_CandidateCost(g, h, vertex_equiv));
+  orders.push_back(vertex_order_GreatestConstraintFirst(g));
+  orders.push_back(vertex_order_RDEG(g));
+  orders.push_back(vertex_order_DEG(g));
+
+  std::mt19937 rng(seed);
+  for (std::size_t k=0; k<num_perturbations && m>1; ++k) {
+    auto order = orders.front();
+    for (IndexG s=0; s<(m+1)/2; ++s) {
+      auto i = static_cast<IndexG>(std::uniform_int_distribution<std::size_t>(0, m-2)(rng));
+      std::swap(order[i], order[i+1]);
+    }
+    orders.push_back(std::move(order));
+  }
+
+  order_cost_explorer<G, H, VertexEquiv, EdgeEquiv> e(g, h, vertex_equiv, edge_equiv);
+
+  std::size_t best = 0;
+  double best_cost = 0;
+  for (std::size_t k=0; k<orders.size(); ++k) {
+    e.set_order(orders[k]);
+    double cost = e.count_nodes(node_budget);
+    if (cost > node_budget) {
+      double sum = 0;
+      for (std::size_t p=0; p<num_probes; ++p) {
+        sum += e.probe(rng);
+      }
+      cost = std::max(cost, num_probes ? sum / num_probes : cost);
+    }
+    if (k == 0 || cost < best_cost) {
+      best = k;
+      best_cost = cost;
+    }
+  }
+  return orders[best];
+}
+
+}  // namespace sics
+
+#endif  // SICS_VERTEX_ORDER_OPTIMIZER_H_
@@ -0,0 +1,387 @@
+#ifndef SICS_VF3_IND_H_
+#define SICS_VF3_IND_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph_traits.h"
+#include "graph_utilities.h"
+#include "label_equivalence.h"
+#include "consistency_utilities.h"
+#include "parent_candidates.h"
+
+#include "stats.h"
+
+namespace sics {
+
+// A VF3-style state-space search, meant to be run with vertex_order_VF3.
+//
+// Vertices are split into classes: with vertex labels and the default label
+// equivalence, one class per label, otherwise a single class.  For a state
+// (the first level vertices of index_order_g mapped), the terminal set of g
+// holds the unmapped vertices adjacent to a mapped one and the new set the
+// other unmapped vertices, and likewise for h.  In an induced embedding
+// extending the state, every neighbour of x in the terminal (new) set of g
+// maps to a neighbour of y in the terminal (new) set of h of the same class,
+// so y is rejected unless, for every class and direction, it has at least
+// as many such neighbours as x.
+//
+// The order is fixed, so the counts for x are computed once per level.  For
+// h, the number of mapped neighbours of every vertex is kept up to date, and
+// the counts for y take one pass over its neighbours, which also checks that
+// y has exactly as many mapped neighbours as x.  Candidates come from the
+// neighbours of the image of the parent of x (see parent_candidates), or the
+// target vertices of the class of x if it has no parent.
+template <
+    typename G,
+    typename H,
+    typename Callback,
+    typename IndexOrderG,
+    typename VertexEquiv = default_vertex_label_equiv<G, H>,
+    typename EdgeEquiv = default_edge_label_equiv<G, H>>
+void vf3_ind(
+    G const & g,
+    H const & h,
+    Callback const & callback,
+    IndexOrderG const & index_order_g,
+    VertexEquiv const & vertex_equiv = VertexEquiv(),
+    EdgeEquiv const & edge_equiv = EdgeEquiv()) {
+
+  using IndexG = typename G::index_type;
+  using IndexH = typename H::index_type;
+
+  struct explorer {
+
+    G const & g;
+    H const & h;
+    Callback callback;
+
+    IndexOrderG const & index_order_g;
+
+    vertex_equiv_helper<VertexEquiv> vertex_equiv;
+    edge_equiv_helper<EdgeEquiv> edge_equiv;
+
+    IndexG m;
+    IndexH n;
+
+    IndexG level;
+
+    std::vector<IndexH> map;
+    std::vector<IndexG> inv;
+
+    // g_class[u], h_class[v]: class ids; classes of g missing from h get
+    // num_classes
+    std::size_t num_classes;
+    std::vector<std::size_t> g_class;
+    std::vector<std::size_t> h_class;
+    std::vector<std::vector<IndexH>> h_class_members;
+    void build_classes() {
+      if constexpr (is_vertex_labelled_v<G> &&
+                    is_vertex_labelled_v<H> &&
+                    std::is_same_v<VertexEquiv, default_vertex_label_equiv<G, H>>) {
+        std::map<typename H::vertex_label_type, std::size_t> ids;
+        for (IndexH v=0; v<n; ++v) {
+          h_class[v] = ids.emplace(h.get_vertex_label(v), ids.size()).first->second;
+        }
+        num_classes = ids.size();
+        for (IndexG u=0; u<m; ++u) {
+          auto it = ids.find(g.get_vertex_label(u));
+          g_class[u] = it != ids.end() ? it->second : num_classes;
+        }
+      } else {
+        num_classes = 1;
+      }
+      h_class_members.resize(num_classes + 1);
+      for (IndexH v=0; v<n; ++v) {
+        h_class_members[h_class[v]].push_back(v);
+      }
+    }
+
+    // counter kinds: neighbours in the terminal or new set, out or in
+    enum : std::size_t {
+      terminal_out,
+      new_out,
+      terminal_in,
+      new_in,
+      num_kinds
+    };
+
+    // per level l, for x = index_order_g[l]: its mapped out- and
+    // in-neighbours, and the lower bounds (class * num_kinds + kind, count)
+    // on the neighbour counts of its image
+    std::vector<IndexG> core_out;
+    std::vector<IndexG> core_in;
+    std::vector<std::vector<std::pair<std::size_t, IndexG>>> lookahead;
+    void build_lookahead() {
+      std::vector<IndexG> position(m);
+      for (IndexG i=0; i<m; ++i) {
+        position[index_order_g[i]] = i;
+      }
+      // first[w]: the position of the first neighbour of w in the order
+      std::vector<IndexG> first(m, m);
+      for (IndexG w=0; w<m; ++w) {
+        for (auto oe : edges_or_out_edges(g, w)) {
+          first[w] = std::min(first[w], position[oe.target]);
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto ie : g.in_edges(w)) {
+            first[w] = std::min(first[w], position[ie.target]);
+          }
+        }
+      }
+
+      std::vector<IndexG> counts((num_classes + 1) * num_kinds);
+      auto add = [&](IndexG l, IndexG w, IndexG & core, std::size_t terminal_kind, std::size_t new_kind) {
+        if (position[w] < l) {
+          ++core;
+        } else if (position[w] > l) {
+          ++counts[g_class[w] * num_kinds + (first[w] < l ? terminal_kind : new_kind)];
+        }
+      };
+      for (IndexG l=0; l<m; ++l) {
+        auto x = index_order_g[l];
+        for (auto oe : edges_or_out_edges(g, x)) {
+          add(l, oe.target, core_out[l], terminal_out, new_out);
+        }
+        if constexpr (is_directed_v<G>) {
+          for (auto ie : g.in_edges(x)) {
+            add(l, ie.target, core_in[l], terminal_in, new_in);
+          }
+        }
+        for (std::size_t k=0; k<counts.size(); ++k) {
+          if (counts[k] > 0) {
+            lookahead[l].emplace_back(k, counts[k]);
+            counts[k] = 0;
+          }
+        }
+      }
+    }
+
+    // h_mapped_neighbours[v]: mapped vertices adjacent to v, so v is in the
+    // terminal set of h iff it is unmapped and this is not 0
+    std::vector<IndexH> h_mapped_neighbours;
+    std::vector<IndexH> h_counts;
+    std::vector<std::size_t> h_touched;
+
+    using parent_type = std::conditional_t<
+        is_directed_v<H>,
+        std::tuple<IndexG, bool>,
+        std::tuple<IndexG>>;
+    std::vector<parent_type> parents;
+    void build_parents() {
+      for (IndexG u=0; u<m; ++u) {
+        std::get<0>(parents[u]) = m;
+      }
+      std::vector<bool> done(m, false);
+      auto end = std::prev(std::cend(index_order_g));
+      for (auto it=std::cbegin(index_order_g); it!=end; ++it) {
+        auto u = *it;
+        done[u] = true;
+        if constexpr (is_directed_v<G>) {
+          for (auto oe : g.out_edges(u)) {
+            auto i = oe.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u, true};
+            }
+          }
+          for (auto ie : g.in_edges(u)) {
+            auto i = ie.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u, false};
+            }
+          }
+        } else {
+          for (auto e : g.edges(u)) {
+            auto i = e.target;
+            if (std::get<0>(parents[i]) == m && !done[i]) {
+              parents[i] = {u};
+            }
+          }
+        }
+      }
+    }
+
+    parent_candidates<G, H, VertexEquiv> candidates;
+
+    explorer(
+        G const & g,
+        H const & h,
+        Callback const & callback,
+        IndexOrderG const & index_order_g,
+        VertexEquiv const & vertex_equiv,
+        EdgeEquiv const & edge_equiv)
+        : g{g},
+          h{h},
+          callback{callback},
+          index_order_g{index_order_g},
+          vertex_equiv{vertex_equiv},
+          edge_equiv{edge_equiv},
+
+          m{g.num_vertices()},
+          n{h.num_vertices()},
+          level{0},
+          map(m, n),
+          inv(n, m),
+          num_classes{0},
+          g_class(m, 0),
+          h_class(n, 0),
+          core_out(m, 0),
+          core_in(m, 0),
+          lookahead(m),
+          h_mapped_neighbours(n, 0),
+          parents(m),
+          candidates(g, h) {
+      build_classes();
+      build_lookahead();
+      h_counts.assign((num_classes + 1) * num_kinds, 0);
+      if (m > 0) {
+        build_parents();
+      }
+    }
+
+    bool explore() {
+      SICS_STATS_STATE;
+      if (level == m) {
+        return callback();
+      } else {
+        auto x = index_order_g[level];
+        bool proceed = true;
+
+        parent_type p = parents[x];
+        if (std::get<0>(p) == m) {
+          for (auto y : h_class_members[g_class[x]]) {
+            if (feasible(y)) {
+              proceed = assign_and_explore(x, y);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        } else {
+          for (auto he : get_parent_edges(x, p)) {
+            auto y = he.target;
+            if (feasible(y)) {
+              proceed = assign_and_explore(x, y);
+              if (!proceed) {
+                break;
+              }
+            }
+          }
+        }
+
+        return proceed;
+      }
+    }
+
+    bool assign_and_explore(IndexG x, IndexH y) {
+      map[x] = y;
+      inv[y] = x;
+      bump_mapped_neighbours(y, 1);
+      ++level;
+      bool proceed = explore();
+      --level;
+      bump_mapped_neighbours(y, -1);
+      inv[y] = m;
+      map[x] = n;
+      return proceed;
+    }
+
+    void bump_mapped_neighbours(IndexH y, int delta) {
+      for (auto oe : edges_or_out_edges(h, y)) {
+        h_mapped_neighbours[oe.target] += delta;
+      }
+      if constexpr (is_directed_v<H>) {
+        for (auto ie : h.in_edges(y)) {
+          h_mapped_neighbours[ie.target] += delta;
+        }
+      }
+    }
+
+    auto get_parent_edges(IndexG x, parent_type p) {
+      if constexpr (is_directed_v<H>) {
+        return candidates.edges(x, map[std::get<0>(p)], std::get<1>(p));
+      } else {
+        return candidates.edges(x, map[std::get<0>(p)]);
+      }
+    }
+
+    bool feasible(IndexH y) {
+      auto x = index_order_g[level];
+
+      if (inv[y] != m ||
+          !vertex_equiv(g, x, h, y) ||
+          !degree_condition(g, x, h, y)) {
+        return false;
+      }
+
+      for (auto oe : edges_or_out_edges(g, x)) {
+        auto u = oe.target;
+        auto v = map[u];
+        if (v != n && (!h.edge(y, v) || !edge_equiv(g, x, u, h, y, v))) {
+          return false;
+        }
+      }
+      if constexpr (is_directed_v<G>) {
+        for (auto ie : g.in_edges(x)) {
+          auto u = ie.target;
+          auto v = map[u];
+          if (v != n && (!h.edge(v, y) || !edge_equiv(g, u, x, h, v, y))) {
+            return false;
+          }
+        }
+      }
+
+      IndexG mapped_out = 0;
+      IndexG mapped_in = 0;
+      for (auto oe : edges_or_out_edges(h, y)) {
+        count(y, oe.target, mapped_out, terminal_out, new_out);
+      }
+      if constexpr (is_directed_v<H>) {
+        for (auto ie : h.in_edges(y)) {
+          count(y, ie.target, mapped_in, terminal_in, new_in);
+        }
+      }
+
+      bool result = mapped_out == core_out[level] && mapped_in == core_in[level];
+      for (auto [k, c] : lookahead[level]) {
+        if (!result) {
+          break;
+        }
+        result = h_counts[k] >= c;
+      }
+
+      for (auto k : h_touched) {
+        h_counts[k] = 0;
+      }
+      h_touched.clear();
+      return result;
+    }
+
+    void count(IndexH y, IndexH w, IndexG & mapped, std::size_t terminal_kind, std::size_t new_kind) {
+      if (w == y) {
+        return;
+      }
+      if (inv[w] != m) {
+        ++mapped;
+      } else {
+        auto k = h_class[w] * num_kinds + (h_mapped_neighbours[w] > 0 ? terminal_kind : new_kind);
+        if (h_counts[k]++ == 0) {
+          h_touched.push_back(k);
+        }
+      }
+    }
+  } e(g, h, callback, index_order_g, vertex_equiv, edge_equiv);
+
+  e.explore();
+}
+
+}  // namespace sics
+
+#endif  // SICS_VF3_IND_H_
@@ -12,6 +12,7 @@
 #include <sics/adjacency_listmat.h>
 
 #include <sics/vertex_order.h>
+#include <sics/vertex_order_optimizer.h>
 
 #include <sics/stats.h>
 
@@ -25,6 +26,7 @@
 #include <sics/backtracking_forwardcount_ind.h>
 #include <sics/backtracking_parent_ind.h>
 #include <sics/backtracking_parent_degreeprune_ind.h>
+#include <sics/backtracking_multiparent_degreeprune_ind.h>
 #include <sics/backtracking_parent_adjacentconsistency_ind.h>
 #include <sics/backtracking_parent_degreeprune_adjacentconsistency_ind.h>
 #include <sics/backtracking_parent_forwardcount_ind.h>
@@ -40,8 +42,10 @@
 #include <sics/conflictbackjumping_ind.h>
 #include <sics/conflictbackjumping_degreeprune_ind.h>
 #include <sics/conflictbackjumping_degreesequenceprune_ind.h>
+#include <sics/conflictbackjumping_nogoodlearning_degreeprune_ind.h>
 #include <sics/backmarking_ind.h>
 #include <sics/backmarking_degreeprune_ind.h>
+#include <sics/backmarking_bitset_degreeprune_ind.h>
 #include <sics/forwardchecking_ind.h>
 #include <sics/forwardchecking_degreeprune_ind.h>
 #include <sics/forwardchecking_degreesequenceprune_ind.h>
@@ -55,6 +59,15 @@
 #include <sics/lazyforwardchecking_parent_degreeprune_ind.h>
 #include <sics/lazyforwardchecking_low_parent_ind.h>
 #include <sics/lazyforwardchecking_low_parent_degreeprune_ind.h>
+#include <sics/lazyforwardchecking_parent_dynamicorder_degreeprune_ind.h>
+#include <sics/lazyforwardchecking_multiparent_degreeprune_ind.h>
+
+#include <sics/vf3_ind.h>
+#include <sics/coreforestleaf_degreeprune_ind.h>
+#include <sics/candidatespace_degreeprune_ind.h>
+#include <sics/failingsets_candidatespace_mrv_degreeprune_ind.h>
+#include <sics/backtracking_parent_nec_degreeprune_ind.h>
+#include <sics/leapfrogtriejoin_degreeprune_ind.h>
 
 #include <sics/forwardchecking_mrv_degreeprune_ind.h>
 
@@ -64,8 +77,11 @@
 #include <sics/forwardchecking_bitset_mrv_degreeprune_ind.h>
 #include <sics/forwardchecking_bitset_mrv_degreeprune_ac1_ind.h>
 #include <sics/forwardchecking_bitset_mrv_degreeprune_countingalldifferent_ind.h>
+#include <sics/forwardchecking_bitset_mrv_degreeprune_restarts_ind.h>
+#include <sics/forwardcheckingconflictbackjumping_bitset_mrv_degreeprune_ind.h>
 #include <sics/forwardchecking_bitset_mrv_degreesequenceprune_ind.h>
 #include <sics/forwardchecking_bitset_mrv_degreesequenceprune_countingalldifferent_ind.h>
+#include <sics/forwardchecking_bitset_domwdeg_degreeprune_countingalldifferent_ind.h>
 
 #include <sics/lazyforwardchecking_parent_degreesequenceprune_ind.h>
 
@@ -73,6 +89,10 @@
 #include <sics/lazyforwardcheckingbackjumping_low_bitset_degreeprune_ind.h>
 
 #include <sics/backtracking_bitset_degreeprune_ind.h>
+#include <sics/backtracking_bitparallel_ind.h>
+#include <sics/backjumping_bitparallel_ind.h>
+#include <sics/backmarking_bitparallel_ind.h>
+#include <sics/lazyforwardchecking_bitparallel_ind.h>
 
 #include <sics/forwardchecking_bitset_degreeprune_ac1_ind.h>
 #include <sics/forwardchecking_bitset_degreeprune_countingalldifferent_ind.h>
@@ -80,6 +100,14 @@
 #include <sics/forwardchecking_bitset_degreesequenceprune_countingalldifferent_ind.h>
 #include <sics/forwardchecking_bitset_mrv_degreesequenceprune_ac1_ind.h>
 
+#include <sics/forwardchecking_hierarchicalbitset_degreeprune_ind.h>
+#include <sics/forwardchecking_hierarchicalbitset_mrv_degreeprune_ind.h>
+#include <sics/forwardchecking_compressedbitset_mrv_degreeprune_ind.h>
+#include <sics/forwardchecking_blockbitset_mrv_degreeprune_ind.h>
+#include <sics/forwardchecking_blockbitset_mrv_degreeprune_countingalldifferent_ind.h>
+#include <sics/forwardchecking_fixedbitset_mrv_degreeprune_ind.h>
+#include <sics/forwardchecking_fixedbitset_mrv_degreeprune_countingalldifferent_ind.h>
+
 int main(int argc, char * argv[]) {
   using namespace sics;
 